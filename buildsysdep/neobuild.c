@@ -17,269 +17,2584 @@
 // for file stats
 #include <sys/stat.h>
 
+// for open
+#include <fcntl.h>
+
+// for mmap
+#include <sys/mman.h>
+
+// for the fixed width format specifiers
+#include <inttypes.h>
+
+// for strcasecmp
+#include <strings.h>
+
+// for the background log writer
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sched.h>
+
 #define MAX_TEMP_STRLEN (2048)
 static neocompiler_t GLOBAL_DEFAULT_COMPILER = GCC;
 
-static inline void cleanup_arg_array(dyn_arr_t *arr)
-{
-    for (int64_t index = 0; index <= (int64_t)(arr)->last_index; index++)
+neolog_level_t neo_log_runtime_level = INFO;
+
+void neo_set_log_level(neolog_level_t level)
+{
+    neo_log_runtime_level = level;
+}
+
+neolog_level_t neo_get_log_level(void)
+{
+    return neo_log_runtime_level;
+}
+
+static const char *neolog_prefix(neolog_level_t level)
+{
+    switch (level)
+    {
+    case ERROR:
+        return "[ERROR] ";
+    case WARNING:
+        return "[WARNING] ";
+    case INFO:
+        return "[INFO] ";
+    case DEBUG:
+        return "[DEBUG] ";
+    default:
+        return "[UNKNOWN] ";
+    }
+}
+
+static FILE *neolog_stream(neolog_level_t level)
+{
+    return level == ERROR || level == WARNING ? stderr : stdout;
+}
+
+#define NEOLOG_SLOT_SIZE (1024)
+#define NEOLOG_DEFAULT_CAPACITY (1024)
+
+// a message in the ring; sequence tells whose turn the slot is (see neolog_enqueue)
+typedef struct
+{
+    _Atomic size_t sequence;
+    neolog_level_t level;
+    size_t len;
+    char text[NEOLOG_SLOT_SIZE];
+} neolog_slot_t;
+
+// bounded multi-producer ring buffer (after Dmitry Vyukov's MPMC queue) drained by a single writer thread
+static struct
+{
+    neolog_slot_t *slots;
+    size_t mask;
+    _Atomic size_t head; // next slot to be claimed by a logger
+    size_t tail;         // next slot to be written out; only touched by the writer
+    atomic_bool active;
+    atomic_bool stopping;
+    atomic_bool sleeping;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+} neolog_ring = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+};
+
+static void neolog_enqueue(neolog_level_t level, const char *format, va_list args)
+{
+    size_t pos = atomic_load_explicit(&neolog_ring.head, memory_order_relaxed);
+    neolog_slot_t *slot;
+    for (;;)
+    {
+        slot = &neolog_ring.slots[pos & neolog_ring.mask];
+        size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (!diff)
+        {
+            if (atomic_compare_exchange_weak_explicit(&neolog_ring.head, &pos, pos + 1, memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the ring is full; wait for the writer rather than losing the message
+            sched_yield();
+            pos = atomic_load_explicit(&neolog_ring.head, memory_order_relaxed);
+        }
+        else
+        {
+            pos = atomic_load_explicit(&neolog_ring.head, memory_order_relaxed);
+        }
+    }
+
+    const char *prefix = neolog_prefix(level);
+    size_t prefix_len = strlen(prefix);
+    memcpy(slot->text, prefix, prefix_len);
+
+    int len = vsnprintf(slot->text + prefix_len, NEOLOG_SLOT_SIZE - prefix_len - 1, format, args);
+    size_t text_len = prefix_len + (len < 0 ? 0 : (size_t)len);
+    if (text_len > NEOLOG_SLOT_SIZE - 2)
+    {
+        text_len = NEOLOG_SLOT_SIZE - 2; // truncated
+    }
+    slot->text[text_len++] = '\n';
+    slot->len = text_len;
+    slot->level = level;
+
+    atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+    if (atomic_load_explicit(&neolog_ring.sleeping, memory_order_seq_cst))
+    {
+        pthread_mutex_lock(&neolog_ring.lock);
+        pthread_cond_signal(&neolog_ring.wake);
+        pthread_mutex_unlock(&neolog_ring.lock);
+    }
+}
+
+// writes out the next message if there is one
+static bool neolog_dequeue(void)
+{
+    neolog_slot_t *slot = &neolog_ring.slots[neolog_ring.tail & neolog_ring.mask];
+    if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != neolog_ring.tail + 1)
+    {
+        return false;
+    }
+
+    fwrite(slot->text, 1, slot->len, neolog_stream(slot->level));
+    atomic_store_explicit(&slot->sequence, neolog_ring.tail + neolog_ring.mask + 1, memory_order_release);
+    neolog_ring.tail++;
+    return true;
+}
+
+static void *neolog_writer(void *arg)
+{
+    (void)arg;
+    for (;;)
+    {
+        while (neolog_dequeue())
+        {
+        }
+
+        // the ring is drained; hand the batch to the terminal before going to sleep
+        fflush(stdout);
+        fflush(stderr);
+
+        if (atomic_load(&neolog_ring.stopping))
+        {
+            return NULL;
+        }
+
+        pthread_mutex_lock(&neolog_ring.lock);
+        atomic_store(&neolog_ring.sleeping, true);
+        neolog_slot_t *slot = &neolog_ring.slots[neolog_ring.tail & neolog_ring.mask];
+        if (atomic_load(&slot->sequence) != neolog_ring.tail + 1 && !atomic_load(&neolog_ring.stopping))
+        {
+            // timed, so that a wakeup racing with going to sleep delays the writer by a few milliseconds at most
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += 10 * 1000 * 1000;
+            if (deadline.tv_nsec >= 1000 * 1000 * 1000)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000 * 1000 * 1000;
+            }
+            pthread_cond_timedwait(&neolog_ring.wake, &neolog_ring.lock, &deadline);
+        }
+        atomic_store(&neolog_ring.sleeping, false);
+        pthread_mutex_unlock(&neolog_ring.lock);
+    }
+}
+
+// the writer thread doesn't exist in a forked child
+static void neolog_atfork_child(void)
+{
+    atomic_store(&neolog_ring.active, false);
+}
+
+bool neo_log_async_start(size_t capacity)
+{
+    if (atomic_load(&neolog_ring.active))
+    {
+        return true;
+    }
+
+    size_t slot_num = 1;
+    while (slot_num < (capacity ? capacity : NEOLOG_DEFAULT_CAPACITY))
+    {
+        slot_num <<= 1;
+    }
+
+    neolog_slot_t *slots = (neolog_slot_t *)malloc(slot_num * sizeof(neolog_slot_t));
+    if (!slots)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed allocating the log ring: %s", __func__, strerror(errno));
+        return false;
+    }
+
+    for (size_t index = 0; index < slot_num; index++)
+    {
+        atomic_init(&slots[index].sequence, index);
+    }
+
+    free(neolog_ring.slots);
+    neolog_ring.slots = slots;
+    neolog_ring.mask = slot_num - 1;
+    atomic_store(&neolog_ring.head, 0);
+    neolog_ring.tail = 0;
+    atomic_store(&neolog_ring.stopping, false);
+    atomic_store(&neolog_ring.sleeping, false);
+
+    int error = pthread_create(&neolog_ring.writer, NULL, neolog_writer, NULL);
+    if (error)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed starting the log writer: %s", __func__, strerror(error));
+        return false;
+    }
+
+    static bool registered = false;
+    if (!registered)
+    {
+        registered = true;
+        pthread_atfork(NULL, NULL, neolog_atfork_child);
+        atexit(neo_log_async_stop);
+    }
+
+    atomic_store(&neolog_ring.active, true);
+    return true;
+}
+
+void neo_log_async_stop(void)
+{
+    if (!atomic_exchange(&neolog_ring.active, false))
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&neolog_ring.lock);
+    atomic_store(&neolog_ring.stopping, true);
+    pthread_cond_signal(&neolog_ring.wake);
+    pthread_mutex_unlock(&neolog_ring.lock);
+    pthread_join(neolog_ring.writer, NULL);
+
+    // messages from loggers that saw the ring active just before it was stopped
+    while (neolog_dequeue())
+    {
+    }
+    fflush(stdout);
+    fflush(stderr);
+}
+
+void neo_logf(neolog_level_t level, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    if (atomic_load_explicit(&neolog_ring.active, memory_order_acquire))
+    {
+        neolog_enqueue(level, format, args);
+    }
+    else
+    {
+        FILE *stream = neolog_stream(level);
+        flockfile(stream); // keeps lines from different threads whole
+        fputs(neolog_prefix(level), stream);
+        vfprintf(stream, format, args);
+        putc_unlocked('\n', stream);
+        funlockfile(stream);
+    }
+
+    va_end(args);
+}
+
+#undef NEOLOG_SLOT_SIZE
+#undef NEOLOG_DEFAULT_CAPACITY
+
+/**
+ * What neobuild measures about itself.
+ */
+typedef enum
+{
+    NEOSTAT_STAT,         /**< stat calls on build step inputs and outputs */
+    NEOSTAT_HASH,         /**< hashing output contents for restat */
+    NEOSTAT_RENDER,       /**< neocmd_render */
+    NEOSTAT_SPAWN,        /**< forking the shell of a command */
+    NEOSTAT_WAIT,         /**< waiting for a command to finish */
+    NEOSTAT_PARSE_CONFIG, /**< neo_parse_config */
+    NEOSTAT_STEP_RUN,     /**< build steps that ran their command (counter) */
+    NEOSTAT_STEP_SKIPPED, /**< build steps that were up to date (counter) */
+    NEOSTAT_COUNT,
+} neostat_kind_t;
+
+static const char *neostat_names[NEOSTAT_COUNT] = {
+    [NEOSTAT_STAT] = "stat",
+    [NEOSTAT_HASH] = "hash",
+    [NEOSTAT_RENDER] = "render",
+    [NEOSTAT_SPAWN] = "spawn",
+    [NEOSTAT_WAIT] = "wait",
+    [NEOSTAT_PARSE_CONFIG] = "parse_config",
+    [NEOSTAT_STEP_RUN] = "steps_run",
+    [NEOSTAT_STEP_SKIPPED] = "steps_skipped",
+};
+
+// relaxed atomics, since commands may be run from several threads; the totals are only read when dumped
+static struct
+{
+    bool enabled;
+    bool json;
+    uint64_t start_ns;
+    struct
+    {
+        _Atomic uint64_t count;
+        _Atomic uint64_t total_ns;
+        _Atomic uint64_t max_ns;
+    } entries[NEOSTAT_COUNT];
+} neostats = {0};
+
+static inline uint64_t neostats_clock(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// starts a span; returns 0 when stats are disabled, which makes the matching neostats_end a no-op
+static inline uint64_t neostats_begin(void)
+{
+    return neostats.enabled ? neostats_clock() : 0;
+}
+
+static inline void neostats_end(neostat_kind_t kind, uint64_t start)
+{
+    if (!start)
+    {
+        return;
+    }
+
+    uint64_t elapsed = neostats_clock() - start;
+    atomic_fetch_add_explicit(&neostats.entries[kind].count, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&neostats.entries[kind].total_ns, elapsed, memory_order_relaxed);
+
+    uint64_t max = atomic_load_explicit(&neostats.entries[kind].max_ns, memory_order_relaxed);
+    while (elapsed > max && !atomic_compare_exchange_weak_explicit(&neostats.entries[kind].max_ns, &max, elapsed, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+}
+
+static inline void neostats_count(neostat_kind_t kind)
+{
+    if (neostats.enabled)
+    {
+        atomic_fetch_add_explicit(&neostats.entries[kind].count, 1, memory_order_relaxed);
+    }
+}
+
+void neo_stats_dump(FILE *stream, bool json)
+{
+    if (!stream)
+    {
+        return;
+    }
+
+    uint64_t wall_ns = neostats.start_ns ? neostats_clock() - neostats.start_ns : 0;
+    if (json)
+    {
+        fprintf(stream, "{\"wall_ns\":%" PRIu64 ",\"stats\":{", wall_ns);
+        for (size_t index = 0; index < NEOSTAT_COUNT; index++)
+        {
+            fprintf(stream, "%s\"%s\":{\"count\":%" PRIu64 ",\"total_ns\":%" PRIu64 ",\"max_ns\":%" PRIu64 "}", index ? "," : "", neostat_names[index],
+                    atomic_load(&neostats.entries[index].count), atomic_load(&neostats.entries[index].total_ns), atomic_load(&neostats.entries[index].max_ns));
+        }
+        fputs("}}\n", stream);
+        return;
+    }
+
+    fprintf(stream, "[neobuild stats] wall time %.3f ms\n", wall_ns / 1e6);
+    fprintf(stream, "%-16s %10s %14s %12s %12s\n", "name", "count", "total ms", "avg us", "max us");
+    for (size_t index = 0; index < NEOSTAT_COUNT; index++)
+    {
+        uint64_t count = atomic_load(&neostats.entries[index].count);
+        uint64_t total_ns = atomic_load(&neostats.entries[index].total_ns);
+        fprintf(stream, "%-16s %10" PRIu64 " %14.3f %12.3f %12.3f\n", neostat_names[index], count, total_ns / 1e6,
+                count ? total_ns / 1e3 / count : 0.0, atomic_load(&neostats.entries[index].max_ns) / 1e3);
+    }
+}
+
+static void neostats_dump_at_exit(void)
+{
+    neo_stats_dump(stderr, neostats.json);
+}
+
+void neo_stats_enable(bool json)
+{
+    neostats.json = json;
+    if (neostats.enabled)
+    {
+        return;
+    }
+
+    neostats.enabled = true;
+    neostats.start_ns = neostats_clock();
+    atexit(neostats_dump_at_exit);
+}
+
+bool neo_parse_stats_arg(char **argv)
+{
+    if (!argv)
+    {
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return false;
+    }
+
+    for (char **arg = argv + 1; *arg; arg++)
+    {
+        if (!strcmp(*arg, "--stats") || !strcmp(*arg, "--stats=table"))
+        {
+            neo_stats_enable(false);
+            return true;
+        }
+
+        if (!strcmp(*arg, "--stats=json"))
+        {
+            neo_stats_enable(true);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+typedef struct
+{
+    const char **items;
+    size_t count;
+    size_t capacity;
+} neopath_vec_t; // neovec array of borrowed path strings
+
+// collects the NULL-terminated object file list of the neo_link* functions into objects
+// returns false if no object file was provided
+static bool collect_object_files(neopath_vec_t *objects, va_list args)
+{
+    const char *tmp = va_arg(args, const char *);
+    while (tmp)
+    {
+        neovec_append(objects, tmp);
+        tmp = va_arg(args, const char *);
+    }
+
+    return objects->count != 0;
+}
+
+// stats an input of a build step; a missing input is an error since the step can't be run without it
+static bool stat_input_file(const char *file, struct stat *file_stat)
+{
+    uint64_t start = neostats_begin();
+    int result = stat(file, file_stat);
+    neostats_end(NEOSTAT_STAT, start);
+
+    if (result == -1)
+    {
+        if (errno != ENOENT)
+        {
+            NEO_LOGF(ERROR, "[%s] Cannot access the file '%s': %s", __func__, file, strerror(errno));
+        }
+        else
+        {
+            NEO_LOGF(ERROR, "[%s] The file '%s' does not exist: %s", __func__, file, strerror(errno));
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// stats the output of a build step; *exists is set to false if the output doesn't exist yet
+static bool stat_output_file(const char *output, struct stat *output_stat, bool *exists)
+{
+    uint64_t start = neostats_begin();
+    int result = stat(output, output_stat);
+    neostats_end(NEOSTAT_STAT, start);
+
+    *exists = true;
+    if (result == -1)
+    {
+        if (errno != ENOENT)
+        {
+            NEO_LOGF(ERROR, "[%s] Cannot access the output file '%s': %s", __func__, output, strerror(errno));
+            return false;
+        }
+
+        *exists = false;
+    }
+
+    return true;
+}
+
+// runs a build command synchronously
+// returns true only if the shell ran and the command it ran exited with status 0
+static bool run_build_command(neocmd_t *cmd)
+{
+    int status = 0, code = 0;
+    if (!neocmd_run_sync(cmd, &status, &code, false))
+    {
+        return false;
+    }
+
+    return code == CLD_EXITED && !status;
+}
+
+#define HASH_SEED 0xcbf29ce484222325ULL
+
+// chains by seeding the hash of data with the hash so far
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+    return strix_hash64(data, len, hash);
+}
+
+static bool hash_file_contents(uint64_t *hash, const char *file_path)
+{
+    if (!strix_hash_file(file_path, *hash, hash))
+    {
+        NEO_LOGF(ERROR, "[%s] Failed hashing '%s': %s", __func__, file_path, strerror(errno));
+        return false;
+    }
+
+    return true;
+}
+
+static bool hash_file(uint64_t *hash, const char *file_path)
+{
+    uint64_t start = neostats_begin();
+    bool result = hash_file_contents(hash, file_path);
+    neostats_end(NEOSTAT_HASH, start);
+    return result;
+}
+
+#define STATE_FILE ".neostate"
+#define STATE_VERSION 4
+
+/**
+ * What neobuild remembers about an output between runs.
+ */
+typedef struct
+{
+    const char *path;      /**< The output, interned in state.paths */
+    uint64_t signature;    /**< Hash of the command (and environment) that last built the output */
+    uint64_t content_hash; /**< Hash of the contents of the output, valid only while output_mtime matches */
+    int64_t output_mtime;  /**< Modification time of the output when the entry was written; 0 if not hashed */
+    int64_t input_mtime;   /**< Newest input modification time the output is known to be up to date with */
+} state_entry_t;
+
+// state entries indexed by the intern id of their output path, persisted in STATE_FILE
+static struct
+{
+    strix_intern_t *paths; // every path is stored once, and its id is the index of its entry
+    state_entry_t *entries;
+    size_t capacity;
+    bool loaded;
+    bool dirty;
+} state = {0};
+
+// returns the entry of path, creating an empty one if there is none yet
+static state_entry_t *state_put(const char *path)
+{
+    if (!state.paths && !(state.paths = strix_intern_create()))
+    {
+        NEO_LOGF(ERROR, "[%s] State table allocation failed: %s", __func__, strerror(errno));
+        return NULL;
+    }
+
+    // ids are handed out in order, so a new path always takes the next entry; there is room for it
+    // before it is interned, so that every interned path has an entry
+    size_t known = strix_intern_count(state.paths);
+    if (known == state.capacity)
+    {
+        size_t new_capacity = state.capacity ? state.capacity * 2 : 256;
+        state_entry_t *new_entries = (state_entry_t *)realloc(state.entries, new_capacity * sizeof(state_entry_t));
+        if (!new_entries)
+        {
+            NEO_LOGF(ERROR, "[%s] State table allocation failed: %s", __func__, strerror(errno));
+            return NULL;
+        }
+        state.entries = new_entries;
+        state.capacity = new_capacity;
+    }
+
+    int64_t id = strix_intern_id(state.paths, strix_view_from_cstr(path));
+    if (id < 0)
+    {
+        NEO_LOGF(ERROR, "[%s] State table allocation failed: %s", __func__, strerror(errno));
+        return NULL;
+    }
+
+    state_entry_t *entry = &state.entries[id];
+    if ((size_t)id == known)
+    {
+        entry->path = strix_intern_get(state.paths, (size_t)id).str;
+        entry->signature = 0;
+        entry->content_hash = 0;
+        entry->output_mtime = 0;
+        entry->input_mtime = 0;
+    }
+
+    return entry;
+}
+
+static void state_save(void)
+{
+    if (!state.dirty)
+    {
+        return;
+    }
+
+    char temp_path[] = STATE_FILE ".tmp";
+    FILE *file = fopen(temp_path, "w");
+    if (!file)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed creating '%s': %s", __func__, temp_path, strerror(errno));
+        return;
+    }
+
+    fprintf(file, "# neostate %d\n", STATE_VERSION);
+    for (size_t index = 0; index < strix_intern_count(state.paths); index++)
+    {
+        state_entry_t *entry = &state.entries[index];
+        fprintf(file, "%016" PRIx64 " %016" PRIx64 " %" PRId64 " %" PRId64 " %s\n", entry->signature, entry->content_hash,
+                entry->output_mtime, entry->input_mtime, entry->path);
+    }
+
+    bool written = !ferror(file);
+    if (fclose(file) || !written || rename(temp_path, STATE_FILE) == -1)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed writing '%s': %s", __func__, STATE_FILE, strerror(errno));
+        unlink(temp_path);
+        return;
+    }
+
+    state.dirty = false;
+}
+
+// loads STATE_FILE on first use; a missing or unreadable state file just means nothing is known yet
+static void state_load(void)
+{
+    if (state.loaded)
+    {
+        return;
+    }
+    state.loaded = true;
+    atexit(state_save);
+
+    FILE *file = fopen(STATE_FILE, "r");
+    if (!file)
+    {
+        return;
+    }
+
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len = getline(&line, &line_cap, file);
+
+    int version = 0;
+    if (line_len > 0 && sscanf(line, "# neostate %d", &version) == 1 && version == STATE_VERSION)
+    {
+        while ((line_len = getline(&line, &line_cap, file)) > 0)
+        {
+            if (line[line_len - 1] == '\n')
+            {
+                line[--line_len] = 0;
+            }
+
+            uint64_t signature, content_hash;
+            int64_t output_mtime, input_mtime;
+            int path_offset;
+            if (sscanf(line, "%" SCNx64 " %" SCNx64 " %" SCNd64 " %" SCNd64 " %n", &signature, &content_hash, &output_mtime, &input_mtime, &path_offset) != 4 ||
+                !line[path_offset])
+            {
+                continue; // skip corrupt lines
+            }
+
+            state_entry_t *entry = state_put(line + path_offset);
+            if (entry)
+            {
+                entry->signature = signature;
+                entry->content_hash = content_hash;
+                entry->output_mtime = output_mtime;
+                entry->input_mtime = input_mtime;
+            }
+        }
+    }
+
+    free(line);
+    fclose(file);
+}
+
+// returns the entry of path, or NULL if nothing is known about it
+static state_entry_t *state_get(const char *path)
+{
+    state_load();
+
+    int64_t id = state.paths ? strix_intern_find(state.paths, strix_view_from_cstr(path)) : -2;
+    return id < 0 ? NULL : &state.entries[id];
+}
+
+#undef STATE_VERSION
+
+static bool restat_enabled = false;
+
+void neo_set_restat(bool restat)
+{
+    restat_enabled = restat;
+}
+
+bool neo_get_restat(void)
+{
+    return restat_enabled;
+}
+
+/**
+ * The kinds of build steps neobuild knows how to bring up to date.
+ */
+typedef enum
+{
+    NEOSTEP_COMPILE, /**< Source file to object file */
+    NEOSTEP_LINK,    /**< Object files to an executable or a shared library */
+    NEOSTEP_ARCHIVE, /**< Object files to a static library, updated member by member */
+} neostep_kind_t;
+
+/**
+ * A single unit of work of the build: the command producing output from inputs.
+ *
+ * Every compile and link function describes its work as a step and hands it to
+ * neostep_execute, which is the only place that decides if a step is stale and runs it.
+ */
+typedef struct
+{
+    neostep_kind_t kind;
+    bool forced;        /**< Run the step even if the output is up to date */
+    bool restat;        /**< Keep the previous timestamp of the output if running the step leaves it unchanged */
+    const char *output; /**< The file produced by the step */
+    const char **inputs;
+    size_t input_num;
+    neocmd_t *cmd;       /**< The command; for archives only the 'ar rcs <archive>' prefix, the stale members are appended when run */
+    size_t input_arg;    /**< Index of the argument of cmd holding the first input (links only), STEP_NO_INPUT_ARG if unknown */
+    const char *depfile; /**< Makefile style dependency file the command writes (can be NULL) */
+} neostep_t;
+
+// the inputs of the step aren't separate arguments of its command, which therefore can't use a response file
+#define STEP_NO_INPUT_ARG SIZE_MAX
+
+// commands longer than this pass their inputs through a response file; sh -c gets the whole command
+// as a single argument, which Linux caps at 128 KiB (MAX_ARG_STRLEN)
+static size_t rsp_threshold = 32 * 1024;
+
+void neo_set_rsp_threshold(size_t threshold)
+{
+    rsp_threshold = threshold;
+}
+
+size_t neo_get_rsp_threshold(void)
+{
+    return rsp_threshold;
+}
+
+// whether the inputs of step go through a response file; only linkers and ar read them
+// pending_len is the length of the arguments still to be appended to the command
+static bool step_uses_rsp(const neostep_t *step, size_t pending_len)
+{
+    return step->kind != NEOSTEP_COMPILE && neocmd_render_len(step->cmd) + pending_len > rsp_threshold;
+}
+
+// builds the command of step with the arg_num arguments starting at first_arg replaced by @rsp_path
+static neocmd_t *rsp_command(const neostep_t *step, size_t first_arg, size_t arg_num, const char *rsp_path)
+{
+    neocmd_t *cmd = neocmd_create(step->cmd->shell);
+    if (!cmd)
+    {
+        return NULL;
+    }
+
+    strix_t rsp_arg = {0};
+    bool appended = strix_appendf(&rsp_arg, "@%s", rsp_path);
+    size_t total = neocmd_arg_num(step->cmd);
+    for (size_t index = 0; index < total && appended; index++)
+    {
+        if (index == first_arg)
+        {
+            appended = neocmd_append(cmd, strix_str(&rsp_arg));
+            index += arg_num - 1;
+        }
+        else
+        {
+            appended = neocmd_append(cmd, neocmd_arg(step->cmd, index));
+        }
+    }
+    strix_clear(&rsp_arg);
+
+    if (!appended)
+    {
+        neocmd_delete(cmd);
+        return NULL;
+    }
+
+    return cmd;
+}
+
+// writes the arg_num arguments of cmd starting at first_arg to the response file rsp_path, one per line
+// the file is left untouched if it already has exactly this content
+static bool rsp_write(const char *rsp_path, const neocmd_t *cmd, size_t first_arg, size_t arg_num)
+{
+    // gcc, ld and ar (through libiberty) split response files at whitespace and honour quotes and
+    // backslash escapes, so those are escaped
+    size_t len = 0;
+    for (size_t index = first_arg; index < first_arg + arg_num; index++)
+    {
+        for (const char *ch = neocmd_arg(cmd, index); *ch; ch++)
+        {
+            len += strchr(" \t\n\\'\"", *ch) ? 2 : 1;
+        }
+        len++;
+    }
+
+    char *content = (char *)malloc(len ? len : 1);
+    if (!content)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed allocating the response file content: %s", __func__, strerror(errno));
+        return false;
+    }
+
+    char *out = content;
+    for (size_t index = first_arg; index < first_arg + arg_num; index++)
+    {
+        for (const char *ch = neocmd_arg(cmd, index); *ch; ch++)
+        {
+            if (strchr(" \t\n\\'\"", *ch))
+            {
+                *out++ = '\\';
+            }
+            *out++ = *ch;
+        }
+        *out++ = '\n';
+    }
+
+    // an unchanged response file keeps its timestamp
+    struct stat rsp_stat;
+    if (stat(rsp_path, &rsp_stat) != -1 && (size_t)rsp_stat.st_size == len)
+    {
+        int fd = open(rsp_path, O_RDONLY);
+        if (fd != -1)
+        {
+            void *existing = len ? mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+            close(fd);
+            bool same = !len || (existing != MAP_FAILED && !memcmp(existing, content, len));
+            if (len && existing != MAP_FAILED)
+            {
+                munmap(existing, len);
+            }
+
+            if (same)
+            {
+                free(content);
+                return true;
+            }
+        }
+    }
+
+    strix_t temp_path = {0};
+    FILE *file = strix_appendf(&temp_path, "%s.tmp", rsp_path) ? fopen(strix_str(&temp_path), "w") : NULL;
+    if (!file)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed creating '%s.tmp': %s", __func__, rsp_path, strerror(errno));
+        strix_clear(&temp_path);
+        free(content);
+        return false;
+    }
+
+    bool written = fwrite(content, 1, len, file) == len;
+    free(content);
+    bool result = true;
+    if (fclose(file) || !written || rename(strix_str(&temp_path), rsp_path) == -1)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed writing '%s': %s", __func__, rsp_path, strerror(errno));
+        unlink(strix_str(&temp_path));
+        result = false;
+    }
+
+    strix_clear(&temp_path);
+    return result;
+}
+
+// runs the command of step, moving its arg_num input arguments starting at first_arg into a response file if it is too long
+static bool run_step_command(const neostep_t *step, size_t first_arg, size_t arg_num)
+{
+    if (!step_uses_rsp(step, 0) || !arg_num || first_arg == STEP_NO_INPUT_ARG || first_arg + arg_num > neocmd_arg_num(step->cmd))
+    {
+        return run_build_command(step->cmd);
+    }
+
+    strix_t rsp_path = {0};
+    if (!strix_appendf(&rsp_path, "%s.rsp", step->output) || !rsp_write(strix_str(&rsp_path), step->cmd, first_arg, arg_num))
+    {
+        strix_clear(&rsp_path);
+        return false;
+    }
+
+    neocmd_t *cmd = rsp_command(step, first_arg, arg_num, strix_str(&rsp_path));
+    if (!cmd)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to create the response file command of '%s'", __func__, step->output);
+        strix_clear(&rsp_path);
+        return false;
+    }
+
+    NEO_LOGF(INFO, "[%s] Passing %zu arguments of '%s' through '%s'", __func__, arg_num, step->output, strix_str(&rsp_path));
+    strix_clear(&rsp_path);
+    bool result = run_build_command(cmd);
+    neocmd_delete(cmd);
+    return result;
+}
+
+static void manifest_record_step(neostep_t *step);
+static bool neocmd_append_len(neocmd_t *neocmd, const char *arg, size_t len);
+static void manifest_mark_incomplete(void);
+static bool ninja_is_active(void);
+static bool ninja_write_step(const neostep_t *step);
+
+// environment variables that change what the compiler and linker produce without showing up on the command line
+static const char *default_signature_env[] = {
+    "CPATH",
+    "C_INCLUDE_PATH",
+    "CPLUS_INCLUDE_PATH",
+    "LIBRARY_PATH",
+    "GCC_EXEC_PREFIX",
+    "COMPILER_PATH",
+    "SOURCE_DATE_EPOCH",
+};
+
+static neopath_vec_t extra_signature_env = NEOVEC_INIT;
+
+bool neo_add_signature_env(const char *name)
+{
+    if (!name || !*name)
+    {
+        NEO_LOGF(ERROR, "[%s] Invalid environment variable name", __func__);
+        return false;
+    }
+
+    char *copy = strdup(name);
+    if (!copy)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed duplicating '%s': %s", __func__, name, strerror(errno));
+        return false;
+    }
+
+    neovec_append(&extra_signature_env, copy);
+    return true;
+}
+
+static uint64_t hash_env(uint64_t hash, const char *name)
+{
+    const char *value = getenv(name);
+    hash = hash_bytes(hash, name, strlen(name) + 1);
+    if (!value)
+    {
+        return hash_bytes(hash, "", 1); // keeps an unset variable distinct from an empty one
+    }
+
+    hash = hash_bytes(hash, "=", 1);
+    return hash_bytes(hash, value, strlen(value) + 1);
+}
+
+// hashes everything that decides what the command of step produces other than its inputs' contents;
+// archive commands get their stale members appended only when they run, so every member is hashed here
+// the trailing separators are left out of the rendered command, as a command replayed from the manifest
+// holds the recorded one as fewer arguments and so doesn't end in the same number of spaces
+static bool step_signature(const neostep_t *step, uint64_t *signature)
+{
+    // most commands fit the stack buffer, sparing an allocation per step
+    char buffer[MAX_TEMP_STRLEN];
+    size_t len = neocmd_render_into(step->cmd, buffer, sizeof(buffer));
+    const char *command = buffer;
+    if (len >= sizeof(buffer))
+    {
+        command = neocmd_render(step->cmd);
+        if (!command)
+        {
+            return false;
+        }
+    }
+
+    size_t hashed_len = len;
+    while (hashed_len && command[hashed_len - 1] == ' ')
+    {
+        hashed_len--;
+    }
+
+    uint64_t hash = hash_bytes(HASH_SEED, command, hashed_len);
+    hash = hash_bytes(hash, "", 1);
+    if (command != buffer)
+    {
+        free((void *)command);
+    }
+
+    if (step->kind == NEOSTEP_ARCHIVE)
+    {
+        for (size_t index = 0; index < step->input_num; index++)
+        {
+            hash = hash_bytes(hash, step->inputs[index], strlen(step->inputs[index]) + 1);
+        }
+    }
+
+    for (size_t index = 0; index < sizeof(default_signature_env) / sizeof(default_signature_env[0]); index++)
+    {
+        hash = hash_env(hash, default_signature_env[index]);
+    }
+
+    neovec_foreach(const char *, name, &extra_signature_env)
+    {
+        hash = hash_env(hash, *name);
+    }
+
+    // 0 marks an entry without a signature
+    *signature = hash ? hash : 1;
+    return true;
+}
+
+// brings the output of the step up to date
+// the output is stale if it doesn't exist, if the step is forced, if the command building it changed
+// or if any of the inputs is newer than it
+static bool neostep_execute(neostep_t *step)
+{
+    // when emitting a ninja manifest, ninja decides what is stale
+    if (ninja_is_active())
+    {
+        return ninja_write_step(step);
+    }
+
+    // recorded only when actually run, so a ninja emission doesn't leave a partial manifest behind
+    manifest_record_step(step);
+
+    NEO_LOGF(DEBUG, "[%s] Forced rebuild of '%s' %s", __func__, step->output, step->forced ? "enabled" : "disabled");
+
+    struct stat output_stat;
+    bool output_exists;
+    if (!stat_output_file(step->output, &output_stat, &output_exists))
+    {
+        manifest_mark_incomplete();
+        return false;
+    }
+
+    uint64_t signature;
+    if (!step_signature(step, &signature))
+    {
+        manifest_mark_incomplete();
+        return false;
+    }
+
+    // an output built by a different command (changed flags, environment or member list) is stale no matter what
+    // the timestamps say; an output without a recorded signature is assumed to have been built by the current command
+    state_entry_t *entry = output_exists ? state_get(step->output) : NULL;
+    bool command_changed = entry && entry->signature && entry->signature != signature;
+    if (command_changed && !step->forced)
+    {
+        NEO_LOGF(INFO, "[%s] The command building '%s' changed; Rebuilding", __func__, step->output);
+    }
+
+    // a forced archive, or one whose command changed, is recreated from scratch so that
+    // members which are no longer part of the object list don't linger in it
+    if ((step->forced || command_changed) && step->kind == NEOSTEP_ARCHIVE && output_exists)
+    {
+        if (unlink(step->output) == -1)
+        {
+            NEO_LOGF(ERROR, "[%s] Failed removing the archive '%s': %s", __func__, step->output, strerror(errno));
+            manifest_mark_incomplete();
+            return false;
+        }
+        output_exists = false;
+        entry = NULL;
+    }
+
+    if (!output_exists)
+    {
+        NEO_LOGF(INFO, "[%s] Output '%s' does not exist - will create", __func__, step->output);
+    }
+
+    // a restat step that left its output unchanged kept the older timestamp of the output;
+    // the output is still up to date with the inputs it was last built from
+    time_t output_mtime = output_exists ? output_stat.st_mtime : 0;
+    if (step->restat && entry && entry->output_mtime == (int64_t)output_stat.st_mtime && entry->input_mtime > (int64_t)output_mtime)
+    {
+        output_mtime = (time_t)entry->input_mtime;
+    }
+
+    // every input is checked even once the step is known to be stale, since a missing input
+    // is an error; archives additionally need the exact set of stale members, as only those
+    // are handed to ar, which replaces them in place and leaves every other member untouched
+    neopath_vec_t stale = NEOVEC_INIT;
+    struct stat input_stat;
+    time_t newest_input_mtime = 0;
+    for (size_t index = 0; index < step->input_num; index++)
+    {
+        const char *input = step->inputs[index];
+        if (!stat_input_file(input, &input_stat))
+        {
+            neovec_free(&stale);
+            manifest_mark_incomplete();
+            return false;
+        }
+
+        if (input_stat.st_mtime > newest_input_mtime)
+        {
+            newest_input_mtime = input_stat.st_mtime;
+        }
+
+        if (step->forced || !output_exists || command_changed || input_stat.st_mtime > output_mtime)
+        {
+            if (output_exists && !step->forced && !command_changed)
+            {
+                NEO_LOGF(INFO, "[%s] The file '%s' is newer than '%s'; Rebuilding", __func__, input, step->output);
+            }
+            neovec_append(&stale, input);
+        }
+    }
+
+    if (!stale.count)
+    {
+        NEO_LOGF(INFO, "[%s] Output '%s' is up to date - skipping", __func__, step->output);
+        neostats_count(NEOSTAT_STEP_SKIPPED);
+
+        // adopt outputs built before their signature was tracked
+        if (!entry || !entry->signature)
+        {
+            entry = state_put(step->output);
+            if (entry)
+            {
+                entry->signature = signature;
+                state.dirty = true;
+            }
+        }
+        return true;
+    }
+
+    // the inputs handed to the command, which go to a response file if the command gets too long
+    size_t first_arg = step->input_arg;
+    size_t arg_num = step->kind == NEOSTEP_COMPILE ? 0 : step->input_num;
+    if (step->kind == NEOSTEP_ARCHIVE)
+    {
+        NEO_LOGF(INFO, "[%s] Updating %zu of %zu members of '%s'", __func__, stale.count, step->input_num, step->output);
+        first_arg = neocmd_arg_num(step->cmd);
+        arg_num = stale.count;
+
+        neovec_foreach(const char *, file, &stale)
+        {
+            neocmd_append(step->cmd, *file);
+        }
+    }
+    neovec_free(&stale);
+
+    // remember what the output looked like before running, so that an unchanged output can be detected
+    uint64_t old_hash = HASH_SEED;
+    bool can_restat = step->restat && output_exists;
+    if (can_restat)
+    {
+        if (entry && entry->output_mtime && entry->output_mtime == (int64_t)output_stat.st_mtime)
+        {
+            old_hash = entry->content_hash;
+        }
+        else
+        {
+            can_restat = hash_file(&old_hash, step->output);
+        }
+    }
+
+    neostats_count(NEOSTAT_STEP_RUN);
+    bool result = run_step_command(step, first_arg, arg_num);
+    if (!result)
+    {
+        NEO_LOGF(ERROR, "[%s] Building '%s' failed", __func__, step->output);
+        manifest_mark_incomplete();
+        return false;
+    }
+
+    NEO_LOGF(INFO, "[%s] Successfully built '%s'", __func__, step->output);
+
+    entry = state_put(step->output);
+    if (!entry)
+    {
+        return true; // the output was built; it just won't be tracked
+    }
+    entry->signature = signature;
+    entry->content_hash = 0;
+    entry->output_mtime = 0;
+    entry->input_mtime = 0;
+    state.dirty = true;
+
+    if (step->restat)
+    {
+        uint64_t new_hash = HASH_SEED;
+        struct stat new_stat;
+        if (!hash_file(&new_hash, step->output) || stat(step->output, &new_stat) == -1)
+        {
+            return true; // the output was built; it just can't be restat
+        }
+
+        // restoring the previous timestamp makes every step depending on the output see it as unchanged
+        time_t new_mtime = new_stat.st_mtime;
+        if (can_restat && new_hash == old_hash)
+        {
+            struct timespec times[2] = {output_stat.st_atim, output_stat.st_mtim};
+            if (!utimensat(AT_FDCWD, step->output, times, 0))
+            {
+                new_mtime = output_stat.st_mtime;
+                NEO_LOGF(INFO, "[%s] Output '%s' is unchanged - keeping its previous timestamp", __func__, step->output);
+            }
+        }
+
+        entry->content_hash = new_hash;
+        entry->output_mtime = (int64_t)new_mtime;
+        entry->input_mtime = (int64_t)newest_input_mtime;
+    }
+
+    return true;
+}
+
+bool neo_link_null(neocompiler_t compiler, const char *executable, const char *linker_flags, bool forced_linking, ...)
+{
+    if (!executable)
+    {
+        NEO_LOGF(ERROR, "[%s] No executable name provided", __func__);
+        return false;
+    }
+
+    neopath_vec_t object = NEOVEC_INIT; // neovec array to keep track of the passed object files
+
+    va_list args;                   // declare a va_list
+    va_start(args, forced_linking); // initialize with the last known fixed argument
+    bool has_objects = collect_object_files(&object, args);
+    va_end(args); // cleanup
+
+    if (!has_objects)
+    {
+        NEO_LOGF(ERROR, "[%s] No object files provided", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    if (compiler == GLOBAL_DEFAULT)
+    {
+        compiler = neo_get_global_default_compiler();
+    }
+
+    neocmd_t *cmd = neocmd_create(SH);
+    if (!cmd)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to create command object", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    switch (compiler)
+    {
+    case GCC:
+        neocmd_append(cmd, "gcc -o", executable);
+        break;
+    case CLANG:
+        neocmd_append(cmd, "clang -o", executable);
+        break;
+    case LD:
+        neocmd_append(cmd, "ld -o", executable);
+        break;
+    default:
+    {
+        NEO_LOGF(ERROR, "[%s] Unsupported compiler type: %d", __func__, compiler);
+        neocmd_delete(cmd);
+        neovec_free(&object);
+        return false;
+    }
+    }
+
+    size_t input_arg = neocmd_arg_num(cmd);
+    neovec_foreach(const char *, file, &object)
+    {
+        neocmd_append(cmd, *file);
+    }
+
+    if (linker_flags)
+    {
+        neocmd_append(cmd, linker_flags);
+    }
+
+    neostep_t step = {
+        .kind = NEOSTEP_LINK,
+        .forced = forced_linking,
+        .restat = restat_enabled,
+        .output = executable,
+        .inputs = object.items,
+        .input_num = object.count,
+        .cmd = cmd,
+        .input_arg = input_arg,
+    };
+    bool result = neostep_execute(&step);
+
+    neocmd_delete(cmd);
+    neovec_free(&object);
+    return result;
+}
+
+bool neo_link_shared_null(neocompiler_t compiler, const char *library, const char *soname, const char *linker_flags, bool forced_linking, ...)
+{
+    if (!library)
+    {
+        NEO_LOGF(ERROR, "[%s] No shared library name provided", __func__);
+        return false;
+    }
+
+    neopath_vec_t object = NEOVEC_INIT;
+
+    va_list args;
+    va_start(args, forced_linking);
+    bool has_objects = collect_object_files(&object, args);
+    va_end(args);
+
+    if (!has_objects)
+    {
+        NEO_LOGF(ERROR, "[%s] No object files provided", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    if (compiler == GLOBAL_DEFAULT)
+    {
+        compiler = neo_get_global_default_compiler();
+    }
+
+    neocmd_t *cmd = neocmd_create(SH);
+    if (!cmd)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to create command object", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    // the compiler drivers forward the soname to the linker through -Wl
+    // while ld takes it directly
+    switch (compiler)
+    {
+    case GCC:
+        neocmd_append(cmd, "gcc -shared -o", library);
+        break;
+    case CLANG:
+        neocmd_append(cmd, "clang -shared -o", library);
+        break;
+    case LD:
+        neocmd_append(cmd, "ld -shared -o", library);
+        break;
+    default:
+    {
+        NEO_LOGF(ERROR, "[%s] Unsupported compiler type: %d", __func__, compiler);
+        neocmd_delete(cmd);
+        neovec_free(&object);
+        return false;
+    }
+    }
+
+    if (soname)
+    {
+        strix_t soname_arg = {0};
+        if (!strix_appendf(&soname_arg, compiler == LD ? "-soname %s" : "-Wl,-soname,%s", soname))
+        {
+            NEO_LOGF(ERROR, "[%s] Failed to build the soname argument", __func__);
+            neocmd_delete(cmd);
+            neovec_free(&object);
+            return false;
+        }
+        neocmd_append(cmd, strix_str(&soname_arg));
+        strix_clear(&soname_arg);
+    }
+
+    size_t input_arg = neocmd_arg_num(cmd);
+    neovec_foreach(const char *, file, &object)
+    {
+        neocmd_append(cmd, *file);
+    }
+
+    if (linker_flags)
+    {
+        neocmd_append(cmd, linker_flags);
+    }
+
+    neostep_t step = {
+        .kind = NEOSTEP_LINK,
+        .forced = forced_linking,
+        .restat = restat_enabled,
+        .output = library,
+        .inputs = object.items,
+        .input_num = object.count,
+        .cmd = cmd,
+        .input_arg = input_arg,
+    };
+    bool result = neostep_execute(&step);
+
+    neocmd_delete(cmd);
+    neovec_free(&object);
+    return result;
+}
+
+bool neo_link_static_null(const char *archive, bool thin_archive, bool forced_archiving, ...)
+{
+    if (!archive)
+    {
+        NEO_LOGF(ERROR, "[%s] No archive name provided", __func__);
+        return false;
+    }
+
+    neopath_vec_t object = NEOVEC_INIT;
+
+    va_list args;
+    va_start(args, forced_archiving);
+    bool has_objects = collect_object_files(&object, args);
+    va_end(args);
+
+    if (!has_objects)
+    {
+        NEO_LOGF(ERROR, "[%s] No object files provided", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    neocmd_t *cmd = neocmd_create(SH);
+    if (!cmd)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to create command object", __func__);
+        neovec_free(&object);
+        return false;
+    }
+
+    // T stores references to the object files instead of copies of them
+    neocmd_append(cmd, thin_archive ? "ar rcsT" : "ar rcs", archive);
+
+    neostep_t step = {
+        .kind = NEOSTEP_ARCHIVE,
+        .forced = forced_archiving,
+        .restat = restat_enabled,
+        .output = archive,
+        .inputs = object.items,
+        .input_num = object.count,
+        .cmd = cmd,
+    };
+    bool result = neostep_execute(&step);
+
+    neocmd_delete(cmd);
+    neovec_free(&object);
+    return result;
+}
+
+#define MANIFEST_MAGIC "NEOMNFST"
+#define MANIFEST_VERSION 1
+
+/*
+ * Layout of a manifest file (native byte order; a manifest is only ever read on the machine that wrote it):
+ *
+ * manifest_header_t
+ * step_num records, each being
+ *     manifest_step_t
+ *     output (output_len bytes + null byte)
+ *     command (command_len bytes + null byte)
+ *     input_num inputs, each being a uint32_t length followed by the path and a null byte
+ *     padding up to the next 8 byte boundary
+ *
+ * All strings are stored null terminated so that replaying uses them straight out of the mapping.
+ */
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t step_num;
+    uint64_t key; // hash of the build file and the other inputs of the build logic
+    uint64_t size; // total size of the manifest in bytes
+} manifest_header_t;
+
+typedef struct
+{
+    uint32_t kind;
+    uint32_t forced;
+    uint32_t input_num;
+    uint32_t output_len;
+    uint32_t command_len;
+    uint32_t restat;
+} manifest_step_t;
+
+typedef enum
+{
+    MANIFEST_INACTIVE,
+    MANIFEST_RECORDING, // the build logic runs and every executed step is serialized
+    MANIFEST_CACHED,    // a valid manifest is mapped and can be replayed
+} manifest_mode_t;
+
+static struct
+{
+    manifest_mode_t mode;
+    char *path;
+    uint64_t key;
+    bool incomplete; // a step failed while recording; such a manifest doesn't capture the full build and is never saved
+
+    uint8_t *buffer; // serialized steps while recording
+    size_t len;
+    size_t capacity;
+    uint32_t step_num;
+
+    void *map; // the mapped manifest while cached
+    size_t map_len;
+} manifest = {0};
+
+static void manifest_put(const void *data, size_t len)
+{
+    if (manifest.len + len > manifest.capacity)
+    {
+        size_t new_capacity = manifest.capacity ? manifest.capacity : 4096;
+        while (new_capacity < manifest.len + len)
+        {
+            new_capacity *= 2;
+        }
+
+        uint8_t *temp = (uint8_t *)realloc(manifest.buffer, new_capacity);
+        if (!temp)
+        {
+            NEO_LOGF(ERROR, "[%s] Manifest buffer allocation failed: %s", __func__, strerror(errno));
+            manifest.incomplete = true;
+            return;
+        }
+        manifest.buffer = temp;
+        manifest.capacity = new_capacity;
+    }
+
+    memcpy(manifest.buffer + manifest.len, data, len);
+    manifest.len += len;
+}
+
+static void manifest_put_str(const char *str, size_t len)
+{
+    manifest_put(str, len);
+    manifest_put("", 1); // null byte
+}
+
+static void manifest_mark_incomplete(void)
+{
+    if (manifest.mode == MANIFEST_RECORDING)
+    {
+        manifest.incomplete = true;
+    }
+}
+
+static void manifest_record_step(neostep_t *step)
+{
+    if (manifest.mode != MANIFEST_RECORDING || manifest.incomplete)
+    {
+        return;
+    }
+
+    const char *command = neocmd_render(step->cmd);
+    if (!command)
+    {
+        manifest.incomplete = true;
+        return;
+    }
+
+    manifest_step_t record = {
+        .kind = (uint32_t)step->kind,
+        .forced = step->forced,
+        .input_num = (uint32_t)step->input_num,
+        .output_len = (uint32_t)strlen(step->output),
+        .command_len = (uint32_t)strlen(command),
+        .restat = step->restat,
+    };
+
+    manifest_put(&record, sizeof(record));
+    manifest_put_str(step->output, record.output_len);
+    manifest_put_str(command, record.command_len);
+    for (size_t index = 0; index < step->input_num; index++)
+    {
+        uint32_t input_len = (uint32_t)strlen(step->inputs[index]);
+        manifest_put(&input_len, sizeof(input_len));
+        manifest_put_str(step->inputs[index], input_len);
+    }
+
+    static const uint8_t padding[8] = {0};
+    manifest_put(padding, (8 - manifest.len % 8) % 8);
+    manifest.step_num++;
+
+    free((void *)command);
+}
+
+// reads the string of the given length (followed by a null byte) at *offset of the mapped manifest
+static const char *manifest_get_str(size_t *offset, size_t len)
+{
+    if (len >= manifest.map_len || *offset > manifest.map_len - len - 1)
+    {
+        return NULL;
+    }
+
+    const char *str = (const char *)manifest.map + *offset;
+    if (str[len])
+    {
+        return NULL;
+    }
+
+    *offset += len + 1;
+    return str;
+}
+
+// walks the steps of the mapped manifest starting at *offset; if step is not NULL, it is filled
+// with the step (the inputs are collected into inputs and the command into cmd)
+static bool manifest_read_step(size_t *offset, neostep_t *step, neopath_vec_t *inputs, const char **command)
+{
+    if (*offset > manifest.map_len - sizeof(manifest_step_t))
+    {
+        return false;
+    }
+
+    manifest_step_t record;
+    memcpy(&record, (const uint8_t *)manifest.map + *offset, sizeof(record));
+    *offset += sizeof(record);
+
+    if (record.kind > NEOSTEP_ARCHIVE)
+    {
+        return false;
+    }
+
+    const char *output = manifest_get_str(offset, record.output_len);
+    const char *cmd = manifest_get_str(offset, record.command_len);
+    if (!output || !cmd)
+    {
+        return false;
+    }
+
+    for (uint32_t index = 0; index < record.input_num; index++)
+    {
+        uint32_t input_len;
+        if (*offset > manifest.map_len - sizeof(input_len))
+        {
+            return false;
+        }
+        memcpy(&input_len, (const uint8_t *)manifest.map + *offset, sizeof(input_len));
+        *offset += sizeof(input_len);
+
+        const char *input = manifest_get_str(offset, input_len);
+        if (!input)
+        {
+            return false;
+        }
+
+        if (inputs)
+        {
+            neovec_append(inputs, input);
+        }
+    }
+
+    *offset += (8 - *offset % 8) % 8;
+
+    if (step)
+    {
+        step->kind = (neostep_kind_t)record.kind;
+        step->forced = record.forced;
+        step->restat = record.restat;
+        step->output = output;
+        step->inputs = inputs->items;
+        step->input_num = inputs->count;
+        *command = cmd;
+    }
+
+    return true;
+}
+
+// maps the manifest and checks that it is intact and was produced by build logic with the current key
+static bool manifest_map(void)
+{
+    int fd = open(manifest.path, O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat manifest_stat;
+    if (fstat(fd, &manifest_stat) == -1 || (size_t)manifest_stat.st_size < sizeof(manifest_header_t))
+    {
+        close(fd);
+        return false;
+    }
+
+    void *map = mmap(NULL, (size_t)manifest_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping stays valid after the descriptor is closed
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    manifest.map = map;
+    manifest.map_len = (size_t)manifest_stat.st_size;
+
+    const manifest_header_t *header = (const manifest_header_t *)map;
+    bool valid = !memcmp(header->magic, MANIFEST_MAGIC, sizeof(header->magic)) &&
+                 header->version == MANIFEST_VERSION &&
+                 header->key == manifest.key &&
+                 header->size == manifest.map_len;
+
+    size_t offset = sizeof(manifest_header_t);
+    for (uint32_t index = 0; valid && index < header->step_num; index++)
+    {
+        valid = manifest_read_step(&offset, NULL, NULL, NULL);
+    }
+
+    if (!valid)
+    {
+        munmap(manifest.map, manifest.map_len);
+        manifest.map = NULL;
+        manifest.map_len = 0;
+    }
+
+    return valid;
+}
+
+bool neo_manifest_open(const char *manifest_path, const char *build_file, const char **inputs, size_t input_num)
+{
+    if (!manifest_path || !build_file || (input_num && !inputs))
+    {
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return false;
+    }
+
+    if (manifest.mode != MANIFEST_INACTIVE)
+    {
+        NEO_LOGF(ERROR, "[%s] A manifest is already open", __func__);
+        return false;
+    }
+
+    uint32_t version = MANIFEST_VERSION;
+    uint64_t key = hash_bytes(HASH_SEED, &version, sizeof(version));
+    if (!hash_file(&key, build_file))
+    {
+        return false;
+    }
+
+    for (size_t index = 0; index < input_num; index++)
+    {
+        // the path is part of the key too, so that swapping config files is noticed
+        key = hash_bytes(key, inputs[index], strlen(inputs[index]) + 1);
+        if (!hash_file(&key, inputs[index]))
+        {
+            return false;
+        }
+    }
+
+    manifest.path = strdup(manifest_path);
+    if (!manifest.path)
+    {
+        NEO_LOGF(ERROR, "[%s] Memory allocation failed: %s", __func__, strerror(errno));
+        return false;
+    }
+    manifest.key = key;
+
+    if (manifest_map())
+    {
+        NEO_LOGF(INFO, "[%s] Manifest '%s' is up to date - build logic can be skipped", __func__, manifest_path);
+        manifest.mode = MANIFEST_CACHED;
+        return true;
+    }
+
+    NEO_LOGF(INFO, "[%s] Manifest '%s' is missing or out of date - recording", __func__, manifest_path);
+
+    manifest.mode = MANIFEST_RECORDING;
+    manifest.incomplete = false;
+    manifest.len = 0;
+    manifest.step_num = 0;
+
+    manifest_header_t header = {0}; // filled in when the manifest is saved
+    manifest_put(&header, sizeof(header));
+    return false;
+}
+
+// splits a recorded command back into arguments for step->cmd, so that the inputs of a link are separate
+// arguments again, which lets them go through a response file; any other command is a single argument
+static bool manifest_command_args(neostep_t *step, const char *command)
+{
+    size_t command_len = strlen(command);
+    step->input_arg = STEP_NO_INPUT_ARG;
+
+    if (step->kind == NEOSTEP_LINK && step->input_num)
+    {
+        // every rendered argument is followed by a space, so the inputs appear as " input ... input "
+        size_t needle_len = 1;
+        for (size_t index = 0; index < step->input_num; index++)
+        {
+            needle_len += strlen(step->inputs[index]) + 1;
+        }
+
+        char *needle = (char *)malloc(needle_len + 1);
+        if (!needle)
+        {
+            NEO_LOGF(ERROR, "[%s] Allocation failed: %s", __func__, strerror(errno));
+            return false;
+        }
+
+        char *end = needle;
+        *end++ = ' ';
+        for (size_t index = 0; index < step->input_num; index++)
+        {
+            size_t len = strlen(step->inputs[index]);
+            memcpy(end, step->inputs[index], len);
+            end += len;
+            *end++ = ' ';
+        }
+        *end = 0;
+
+        const char *found = strstr(command, needle);
+        free(needle);
+        if (found && found != command)
+        {
+            const char *tail = found + needle_len;
+            size_t tail_len = command_len - (size_t)(tail - command);
+
+            bool appended = neocmd_append_len(step->cmd, command, (size_t)(found - command));
+            step->input_arg = 1;
+            for (size_t index = 0; appended && index < step->input_num; index++)
+            {
+                appended = neocmd_append(step->cmd, step->inputs[index]);
+            }
+            if (appended && tail_len)
+            {
+                appended = neocmd_append_len(step->cmd, tail, tail_len - 1);
+            }
+
+            return appended;
+        }
+    }
+
+    return neocmd_append(step->cmd, command);
+}
+
+bool neo_manifest_replay(void)
+{
+    if (manifest.mode != MANIFEST_CACHED)
+    {
+        NEO_LOGF(ERROR, "[%s] No up to date manifest is open", __func__);
+        return false;
+    }
+
+    const manifest_header_t *header = (const manifest_header_t *)manifest.map;
+    size_t offset = sizeof(manifest_header_t);
+    bool result = true;
+
+    for (uint32_t index = 0; result && index < header->step_num; index++)
+    {
+        neopath_vec_t inputs = NEOVEC_INIT;
+        neostep_t step;
+        const char *command;
+        if (!manifest_read_step(&offset, &step, &inputs, &command))
+        {
+            neovec_free(&inputs);
+            return false; // can't happen; the manifest was validated when it was mapped
+        }
+
+        step.cmd = neocmd_create(SH);
+        if (!step.cmd || !manifest_command_args(&step, command))
+        {
+            if (step.cmd)
+            {
+                neocmd_delete(step.cmd);
+            }
+            neovec_free(&inputs);
+            return false;
+        }
+
+        result = neostep_execute(&step);
+
+        neocmd_delete(step.cmd);
+        neovec_free(&inputs);
+    }
+
+    return result;
+}
+
+bool neo_manifest_close(void)
+{
+    bool result = true;
+
+    if (manifest.mode == MANIFEST_RECORDING && manifest.incomplete)
+    {
+        NEO_LOGF(INFO, "[%s] The build didn't complete; not saving manifest '%s'", __func__, manifest.path);
+    }
+    else if (manifest.mode == MANIFEST_RECORDING)
+    {
+        manifest_header_t header = {0};
+        memcpy(header.magic, MANIFEST_MAGIC, sizeof(header.magic));
+        header.version = MANIFEST_VERSION;
+        header.step_num = manifest.step_num;
+        header.key = manifest.key;
+        header.size = manifest.len;
+        memcpy(manifest.buffer, &header, sizeof(header));
+
+        // write to a temporary file and rename it over the manifest so that a
+        // crash never leaves a truncated manifest behind
+        strix_t temp_path = {0};
+        FILE *file = strix_appendf(&temp_path, "%s.tmp", manifest.path) ? fopen(strix_str(&temp_path), "wb") : NULL;
+        bool written = file && fwrite(manifest.buffer, 1, manifest.len, file) == manifest.len;
+        if (file && fclose(file))
+        {
+            written = false;
+        }
+
+        if (!written || rename(strix_str(&temp_path), manifest.path) == -1)
+        {
+            NEO_LOGF(ERROR, "[%s] Failed writing manifest '%s': %s", __func__, manifest.path, strerror(errno));
+            result = false;
+        }
+        strix_clear(&temp_path);
+    }
+    else if (manifest.mode == MANIFEST_CACHED)
+    {
+        munmap(manifest.map, manifest.map_len);
+    }
+
+    free(manifest.buffer);
+    free(manifest.path);
+    memset(&manifest, 0, sizeof(manifest));
+    return result;
+}
+
+#undef MANIFEST_MAGIC
+#undef MANIFEST_VERSION
+
+static struct
+{
+    FILE *file;
+    char *path;
+    bool failed; // a write failed; the manifest is dropped when the emission ends
+} ninja = {0};
+
+static bool ninja_is_active(void)
+{
+    return ninja.file != NULL;
+}
+
+// ninja has no escape for a newline (a '$' before it continues the line), so such strings are refused
+static bool ninja_check_newline(const char *str)
+{
+    if (strchr(str, '\n'))
+    {
+        NEO_LOGF(ERROR, "[%s] Can't write '%s' to the ninja manifest: it contains a newline", __func__, str);
+        ninja.failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+// paths in build statements need spaces, colons and dollars escaped
+static bool ninja_write_path(const char *path)
+{
+    if (!ninja_check_newline(path))
+    {
+        return false;
+    }
+
+    for (const char *ptr = path; *ptr; ptr++)
+    {
+        if (*ptr == '$' || *ptr == ' ' || *ptr == ':')
+        {
+            fputc('$', ninja.file);
+        }
+        fputc(*ptr, ninja.file);
+    }
+
+    return true;
+}
+
+// variable values are only subject to $ expansion
+static bool ninja_write_value(const char *value)
+{
+    if (!ninja_check_newline(value))
+    {
+        return false;
+    }
+
+    for (const char *ptr = value; *ptr; ptr++)
+    {
+        if (*ptr == '$')
+        {
+            fputc('$', ninja.file);
+        }
+        fputc(*ptr, ninja.file);
+    }
+
+    return true;
+}
+
+static bool ninja_write_step(const neostep_t *step)
+{
+    // ninja writes the response file itself (from $in), so only the command has to refer to it
+    size_t members_len = 0;
+    if (step->kind == NEOSTEP_ARCHIVE)
+    {
+        for (size_t index = 0; index < step->input_num; index++)
+        {
+            members_len += strlen(step->inputs[index]) + 1;
+        }
+    }
+
+    bool uses_rsp = step_uses_rsp(step, members_len) &&
+                    (step->kind == NEOSTEP_ARCHIVE || (step->input_arg != STEP_NO_INPUT_ARG && step->input_arg + step->input_num <= neocmd_arg_num(step->cmd)));
+    neocmd_t *rsp_cmd = NULL;
+    if (uses_rsp && step->kind == NEOSTEP_LINK)
+    {
+        strix_t rsp_path = {0};
+        rsp_cmd = strix_appendf(&rsp_path, "%s.rsp", step->output) ? rsp_command(step, step->input_arg, step->input_num, strix_str(&rsp_path)) : NULL;
+        strix_clear(&rsp_path);
+        if (!rsp_cmd)
+        {
+            ninja.failed = true;
+            return false;
+        }
+    }
+
+    const char *command = neocmd_render(rsp_cmd ? rsp_cmd : step->cmd);
+    if (rsp_cmd)
+    {
+        neocmd_delete(rsp_cmd);
+    }
+    if (!command)
+    {
+        ninja.failed = true;
+        return false;
+    }
+
+    const char *rule;
+    switch (step->kind)
+    {
+    case NEOSTEP_COMPILE:
+        rule = step->depfile ? "neo_compile_deps" : "neo_compile";
+        break;
+    case NEOSTEP_ARCHIVE:
+        rule = uses_rsp ? "neo_archive_rsp" : "neo_archive";
+        break;
+    default:
+        rule = uses_rsp ? "neo_link_rsp" : "neo_link";
+        break;
+    }
+
+    fputs("build ", ninja.file);
+    bool written = ninja_write_path(step->output);
+    fprintf(ninja.file, ": %s", rule);
+    for (size_t index = 0; written && index < step->input_num; index++)
+    {
+        fputc(' ', ninja.file);
+        written = ninja_write_path(step->inputs[index]);
+    }
+
+    fputs("\n  cmd = ", ninja.file);
+    written = written && ninja_write_value(command);
+    if (step->restat)
+    {
+        fputs("\n  restat = 1", ninja.file);
+    }
+    if (written && step->depfile)
+    {
+        fputs("\n  depfile = ", ninja.file);
+        written = ninja_write_value(step->depfile);
+    }
+    fputs("\n\n", ninja.file);
+
+    free((void *)command);
+    if (!written || ferror(ninja.file))
+    {
+        ninja.failed = true;
+        return false;
+    }
+
+    return true;
+}
+
+bool neo_ninja_begin(const char *ninja_path)
+{
+    if (!ninja_path)
+    {
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return false;
+    }
+
+    if (ninja_is_active())
+    {
+        NEO_LOGF(ERROR, "[%s] A ninja manifest is already being emitted", __func__);
+        return false;
+    }
+
+    strix_t temp_path = {0};
+    ninja.path = strdup(ninja_path);
+    ninja.file = ninja.path && strix_appendf(&temp_path, "%s.tmp", ninja_path) ? fopen(strix_str(&temp_path), "w") : NULL;
+    strix_clear(&temp_path);
+    if (!ninja.file)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed creating '%s.tmp': %s", __func__, ninja_path, strerror(errno));
+        free(ninja.path);
+        ninja.path = NULL;
+        return false;
+    }
+    ninja.failed = false;
+
+    // the archive rule recreates the archive since ninja has no notion of updating it member by member
+    fputs("# generated by neobuild; edit the build file instead\n"
+          "ninja_required_version = 1.3\n"
+          "\n"
+          "rule neo_compile\n"
+          "  command = $cmd\n"
+          "  description = CC $out\n"
+          "\n"
+          "rule neo_compile_deps\n"
+          "  command = $cmd\n"
+          "  description = CC $out\n"
+          "  depfile = $depfile\n"
+          "  deps = gcc\n"
+          "\n"
+          "rule neo_link\n"
+          "  command = $cmd\n"
+          "  description = LINK $out\n"
+          "\n"
+          "rule neo_archive\n"
+          "  command = rm -f $out && $cmd $in\n"
+          "  description = AR $out\n"
+          "\n"
+          "rule neo_link_rsp\n"
+          "  command = $cmd\n"
+          "  description = LINK $out\n"
+          "  rspfile = $out.rsp\n"
+          "  rspfile_content = $in_newline\n"
+          "\n"
+          "rule neo_archive_rsp\n"
+          "  command = rm -f $out && $cmd @$out.rsp\n"
+          "  description = AR $out\n"
+          "  rspfile = $out.rsp\n"
+          "  rspfile_content = $in_newline\n"
+          "\n",
+          ninja.file);
+
+    NEO_LOGF(INFO, "[%s] Emitting build steps to '%s' instead of running them", __func__, ninja_path);
+    return true;
+}
+
+bool neo_ninja_end(void)
+{
+    if (!ninja_is_active())
+    {
+        NEO_LOGF(ERROR, "[%s] No ninja manifest is being emitted", __func__);
+        return false;
+    }
+
+    strix_t temp_path = {0};
+    bool result = !ninja.failed && !ferror(ninja.file) && strix_appendf(&temp_path, "%s.tmp", ninja.path);
+    if (fclose(ninja.file))
+    {
+        result = false;
+    }
+
+    if (!result || rename(strix_str(&temp_path), ninja.path) == -1)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed writing '%s': %s", __func__, ninja.path, strerror(errno));
+        if (strix_str(&temp_path))
+        {
+            unlink(strix_str(&temp_path));
+        }
+        result = false;
+    }
+    else
+    {
+        NEO_LOGF(INFO, "[%s] Wrote ninja manifest '%s'", __func__, ninja.path);
+    }
+    strix_clear(&temp_path);
+
+    free(ninja.path);
+    ninja.path = NULL;
+    ninja.file = NULL;
+    return result;
+}
+
+neoconfig_t *neo_parse_config_arg(char **argv, size_t *config_arr_len)
+{
+    if (!argv || !config_arr_len)
+    {
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return NULL;
+    }
+
+    // the path is used straight out of argv, however long it is
+    for (char **temp = argv + 1; *temp; temp++)
     {
-        strix_t *temp;
-        if (dyn_arr_get((arr), index, &temp)) // we will inevitably be leaking memory if dyn_arr_get fails for some index and that index is allocated
+        char *start = strstr(*temp, "--config=");
+        if (start)
         {
-            strix_free(temp);
+            start += 9; // Skip "--config="
+            if (*start)
+            {
+                return neo_parse_config(start, config_arr_len);
+            }
+            break;
         }
     }
-}
 
-#define APPEND_CLEANUP(arr)     \
-    do                          \
-    {                           \
-        strix_free(arg_strix);  \
-        cleanup_arg_array(arr); \
-        va_end(args);           \
-        return false;           \
-    } while (0)
+    NEO_LOGF(INFO, "[%s] No configuration argument found", __func__);
+    return NULL;
+}
 
-bool neo_link_null(neocompiler_t compiler, const char *executable, const char *linker_flags, bool forced_linking, ...)
+bool neo_free_config(neoconfig_t *config_arr, size_t config_num)
 {
-    if (!executable)
+    if (!config_arr)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] No executable name provided", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
         return false;
     }
 
-    struct
+    for (size_t index = 0; index < config_num; index++)
     {
-        const char **items;
-        size_t count;
-        size_t capacity;
-    } object = NEOVEC_INIT; // neovec array to keep track of the passed object files
+        free(config_arr[index].key);
+        free(config_arr[index].value);
+    }
 
-    va_list args;                   // declare a va_list
-    va_start(args, forced_linking); // initialize with the last known fixed argument
+    free(config_arr);
 
-    const char *tmp = va_arg(args, const char *);
-    while (tmp)
+    return true;
+}
+
+typedef struct
+{
+    const char *key;   // NULL for an empty slot
+    const char *value;
+    uint64_t hash;
+    const char **list; // value split at whitespace, built on the first neo_config_get_list
+    size_t list_num;
+} config_entry_t;
+
+struct neoconfig_store
+{
+    config_entry_t *entries;
+    size_t capacity; // always a power of two
+    size_t count;
+    char *arena;     // every key and value, NUL terminated
+};
+
+static config_entry_t *config_slot(const neoconfig_store_t *store, const char *key, size_t key_len, uint64_t hash)
+{
+    size_t index = hash & (store->capacity - 1);
+    while (store->entries[index].key &&
+           (store->entries[index].hash != hash || strncmp(store->entries[index].key, key, key_len) || store->entries[index].key[key_len]))
     {
-        neovec_append(&object, tmp);
-        tmp = va_arg(args, const char *);
+        index = (index + 1) & (store->capacity - 1);
     }
 
-    va_end(args); // cleanup
+    return &store->entries[index];
+}
 
-    if (!object.count)
+static bool config_grow(neoconfig_store_t *store)
+{
+    size_t capacity = store->capacity * 2;
+    config_entry_t *entries = (config_entry_t *)calloc(capacity, sizeof(config_entry_t));
+    if (!entries)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] No object files provided", __func__);
-        NEO_LOG(ERROR, msg);
-        neovec_free(&object);
+        NEO_LOGF(ERROR, "[%s] Config store allocation failed: %s", __func__, strerror(errno));
         return false;
     }
 
-    char force_msg[MAX_TEMP_STRLEN];
-    snprintf(force_msg, sizeof(force_msg), "[%s] Forced linking %s", __func__, forced_linking ? "enabled" : "disabled");
-    NEO_LOG(INFO, force_msg);
-
-    bool requires_linking = forced_linking;
-    bool exec_exists = true;
-    if (!forced_linking)
+    for (size_t index = 0; index < store->capacity; index++)
     {
-        struct stat exec_stat;
-        if (stat(executable, &exec_stat) == -1)
+        config_entry_t *entry = &store->entries[index];
+        if (entry->key)
         {
-            char msg[MAX_TEMP_STRLEN];
-            if (errno != ENOENT)
+            size_t slot = entry->hash & (capacity - 1);
+            while (entries[slot].key)
             {
-                snprintf(msg, sizeof(msg), "[%s] Cannot access the executable file '%s': %s", __func__, executable, strerror(errno));
-                NEO_LOG(ERROR, msg);
-                neovec_free(&object);
-                return false;
+                slot = (slot + 1) & (capacity - 1);
             }
-            exec_exists = false;
-            requires_linking = true;
-
-            snprintf(msg, sizeof(msg), "[%s] Executable '%s' does not exist - will create", __func__, executable);
-            NEO_LOG(INFO, msg);
+            entries[slot] = *entry;
         }
+    }
+
+    free(store->entries);
+    store->entries = entries;
+    store->capacity = capacity;
+    return true;
+}
+
+// parses 'key = value;' statements in a single pass over data
+static bool config_parse(neoconfig_store_t *store, const char *data, size_t len)
+{
+    store->capacity = 64;
+    store->entries = (config_entry_t *)calloc(store->capacity, sizeof(config_entry_t));
+    store->arena = (char *)malloc(len + 1); // keys and values (plus their terminators) never outgrow the file
+    if (!store->entries || !store->arena)
+    {
+        NEO_LOGF(ERROR, "[%s] Config store allocation failed: %s", __func__, strerror(errno));
+        return false;
+    }
 
-        struct stat temp;
-        const char **file;
-        neovec_foreach(const char *, file, &object)
+    char *arena = store->arena;
+    strix_view_t rest = {data, len};
+    while (rest.len)
+    {
+        strix_view_t statement, key, value;
+        strix_view_cut(rest, ';', &statement, &rest);
+        bool has_value = strix_view_cut(statement, '=', &key, &value);
+        key = strix_view_trim_whitespace(key);
+
+        if (!has_value || !key.len)
         {
-            if (stat(*file, &temp) == -1)
+            if (key.len) // blank statements (like the one after a trailing ';') are fine
             {
-                char msg[MAX_TEMP_STRLEN];
-                if (errno != ENOENT)
-                {
-                    snprintf(msg, sizeof(msg), "[%s] Cannot access the file '%s': %s", __func__, *file, strerror(errno));
-                    NEO_LOG(ERROR, msg);
-                    neovec_free(&object);
-                    return false;
-                }
-                else
-                {
-                    snprintf(msg, sizeof(msg), "[%s] The file '%s' does not exist: %s", __func__, *file, strerror(errno));
-                    NEO_LOG(ERROR, msg);
-                    neovec_free(&object);
-                    return false;
-                }
+                NEO_LOGF(ERROR, "[%s] Invalid Config-Value pair: " STRIX_FORMAT, __func__, STRIX_PRINT(&statement));
             }
+            continue;
+        }
 
-            if (exec_exists && temp.st_mtime > exec_stat.st_mtime)
+        value = strix_view_trim_whitespace(value);
+        uint64_t hash = hash_bytes(HASH_SEED, key.str, key.len);
+
+        config_entry_t *entry = config_slot(store, key.str, key.len, hash);
+        if (!entry->key && (store->count + 1) * 2 > store->capacity) // keep the load factor under 0.5
+        {
+            if (!config_grow(store))
             {
-                char msg[MAX_TEMP_STRLEN];
-                snprintf(msg, sizeof(msg), "[%s] The file '%s' is newer than the executable; Linking will be done", __func__, *file);
-                NEO_LOG(INFO, msg);
-                requires_linking = true;
+                return false;
             }
+            entry = config_slot(store, key.str, key.len, hash);
         }
 
-        if (exec_exists && !requires_linking)
+        if (!entry->key)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Executable '%s' is up to date - skipping linking", __func__, executable);
-            NEO_LOG(INFO, msg);
-            neovec_free(&object);
-            return true;
+            memcpy(arena, key.str, key.len);
+            arena[key.len] = 0;
+            entry->key = arena;
+            entry->hash = hash;
+            arena += key.len + 1;
+            store->count++;
+        }
+
+        // a repeated key takes the later value; the space of the earlier one is simply not reused
+        if (value.len)
+        {
+            memcpy(arena, value.str, value.len);
         }
+        arena[value.len] = 0;
+        entry->value = arena;
+        arena += value.len + 1;
     }
 
-    if (compiler == GLOBAL_DEFAULT)
+    return true;
+}
+
+static neoconfig_store_t *config_load(const char *config_file_path)
+{
+    if (!config_file_path)
     {
-        compiler = neo_get_global_default_compiler();
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return NULL;
     }
 
-    neocmd_t *cmd = neocmd_create(SH);
-    if (!cmd)
+    const strix_t *file = strix_map_file(config_file_path);
+    if (!file)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Failed to create command object", __func__);
-        NEO_LOG(ERROR, msg);
-        neovec_free(&object);
-        return false;
+        NEO_LOGF(ERROR, "[%s] Failed reading '%s': %s", __func__, config_file_path, strerror(errno));
+        return NULL;
     }
 
-    switch (compiler)
-    {
-    case GCC:
-        neocmd_append(cmd, "gcc -o", executable);
-        break;
-    case CLANG:
-        neocmd_append(cmd, "clang -o", executable);
-        break;
-    case LD:
-        neocmd_append(cmd, "ld -o", executable);
-        break;
-    default:
+    neoconfig_store_t *store = (neoconfig_store_t *)calloc(1, sizeof(neoconfig_store_t));
+    bool parsed = store && config_parse(store, strix_str(file), strix_len(file));
+    strix_unmap_file(file);
+
+    if (!parsed)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Unsupported compiler type: %d", __func__, compiler);
-        NEO_LOG(ERROR, msg);
-        neocmd_delete(cmd);
-        neovec_free(&object);
-        return false;
-    }
+        if (store)
+        {
+            neo_config_free(store);
+        }
+        else
+        {
+            NEO_LOGF(ERROR, "[%s] Config store allocation failed: %s", __func__, strerror(errno));
+        }
+        return NULL;
     }
 
-    const char **file;
-    neovec_foreach(const char *, file, &object)
+    return store;
+}
+
+neoconfig_store_t *neo_config_load(const char *config_file_path)
+{
+    uint64_t start = neostats_begin();
+    neoconfig_store_t *store = config_load(config_file_path);
+    neostats_end(NEOSTAT_PARSE_CONFIG, start);
+    return store;
+}
+
+neoconfig_store_t *neo_config_load_arg(char **argv)
+{
+    if (!argv)
     {
-        neocmd_append(cmd, *file);
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
+        return NULL;
     }
 
-    if (linker_flags)
+    for (char **arg = argv + 1; *arg; arg++)
     {
-        neocmd_append(cmd, linker_flags);
+        if (!strncmp(*arg, "--config=", 9))
+        {
+            return neo_config_load(*arg + 9);
+        }
     }
 
-    int status, code;
-    bool result = neocmd_run_sync(cmd, &status, &code, false);
-    if (!result && !code)
+    NEO_LOGF(INFO, "[%s] No configuration argument found", __func__);
+    return NULL;
+}
+
+void neo_config_free(neoconfig_store_t *store)
+{
+    if (!store)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Linking failed for '%s'", __func__, executable);
-        NEO_LOG(ERROR, msg);
+        return;
     }
-    else
+
+    if (store->entries)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Successfully linked '%s'", __func__, executable);
-        NEO_LOG(INFO, msg);
+        for (size_t index = 0; index < store->capacity; index++)
+        {
+            free(store->entries[index].list);
+        }
     }
 
-    neocmd_delete(cmd);
-    neovec_free(&object);
-    return result;
+    free(store->entries);
+    free(store->arena);
+    free(store);
 }
 
-neoconfig_t *neo_parse_config_arg(char **argv, size_t *config_arr_len)
+size_t neo_config_count(const neoconfig_store_t *store)
 {
-    if (!argv || !config_arr_len)
+    return store ? store->count : 0;
+}
+
+static config_entry_t *config_find(const neoconfig_store_t *store, const char *key)
+{
+    if (!store || !key || !store->count)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Arguments invalid", __func__);
-        NEO_LOG(ERROR, msg);
         return NULL;
     }
 
-    char file_name[MAX_TEMP_STRLEN] = {0};
-    char *ptr = (char *)file_name;
-    char **temp = argv;
-    temp++;
+    size_t key_len = strlen(key);
+    config_entry_t *entry = config_slot(store, key, key_len, hash_bytes(HASH_SEED, key, key_len));
+    return entry->key ? entry : NULL;
+}
 
-    while (*temp)
-    {
-        char *start = strstr(*temp, "--config=");
-        if (start)
-        {
-            start += 9; // Skip "--config="
-            while (*start)
-            {
-                *ptr++ = *start++;
-            }
+const char *neo_config_get(const neoconfig_store_t *store, const char *key)
+{
+    config_entry_t *entry = config_find(store, key);
+    return entry ? entry->value : NULL;
+}
 
-            *ptr = 0; // null terminate
-            break;
-        }
+bool neo_config_get_bool(const neoconfig_store_t *store, const char *key, bool *value)
+{
+    const char *str = neo_config_get(store, key);
+    if (!str || !value)
+    {
+        return false;
+    }
 
-        temp++;
+    if (!strcasecmp(str, "true") || !strcasecmp(str, "yes") || !strcasecmp(str, "on") || !strcmp(str, "1"))
+    {
+        *value = true;
+        return true;
     }
 
-    if (ptr == file_name)
+    if (!strcasecmp(str, "false") || !strcasecmp(str, "no") || !strcasecmp(str, "off") || !strcmp(str, "0"))
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] No configuration argument found", __func__);
-        NEO_LOG(INFO, msg);
-        return NULL;
+        *value = false;
+        return true;
     }
 
-    return neo_parse_config((const char *)file_name, config_arr_len);
+    NEO_LOGF(ERROR, "[%s] The value of '%s' is not a boolean: %s", __func__, key, str);
+    return false;
 }
 
-bool neo_free_config(neoconfig_t *config_arr, size_t config_num)
+bool neo_config_get_int(const neoconfig_store_t *store, const char *key, int64_t *value)
 {
-    if (!config_arr)
+    const char *str = neo_config_get(store, key);
+    if (!str || !value)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Arguments invalid", __func__);
-        NEO_LOG(ERROR, msg);
         return false;
     }
 
-    for (size_t index = 0; index < config_num; index++)
+    char *end;
+    errno = 0;
+    long long parsed = strtoll(str, &end, 0);
+    if (end == str || *end || errno == ERANGE)
     {
-        free(config_arr[index].key);
-        free(config_arr[index].value);
+        NEO_LOGF(ERROR, "[%s] The value of '%s' is not an integer: %s", __func__, key, str);
+        return false;
     }
 
-    free(config_arr);
-
+    *value = (int64_t)parsed;
     return true;
 }
 
+const char **neo_config_get_list(neoconfig_store_t *store, const char *key, size_t *count)
+{
+    config_entry_t *entry = config_find(store, key);
+    if (!entry || !count)
+    {
+        return NULL;
+    }
+
+    if (!entry->list)
+    {
+        // whitespace as the C locale classifies it, so that lists split the same in every locale
+        static const char whitespace[] = " \t\n\v\f\r";
+
+        // a copy of the value is split in place, its whitespace becoming terminators
+        size_t value_len = strlen(entry->value);
+        size_t item_num = 0;
+        for (const char *ch = entry->value + strspn(entry->value, whitespace); *ch; ch += strspn(ch, whitespace))
+        {
+            item_num++;
+            ch += strcspn(ch, whitespace);
+        }
+
+        // the item pointers and a copy of the value share one allocation
+        const char **list = (const char **)malloc((item_num ? item_num : 1) * sizeof(const char *) + value_len + 1);
+        if (!list)
+        {
+            NEO_LOGF(ERROR, "[%s] List allocation failed: %s", __func__, strerror(errno));
+            return NULL;
+        }
+
+        char *copy = (char *)(list + (item_num ? item_num : 1));
+        memcpy(copy, entry->value, value_len + 1);
+
+        // every kind of whitespace becomes a space for the split iterator, which skips the empty pieces of runs
+        for (char *ch = strpbrk(copy, whitespace + 1); ch; ch = strpbrk(ch + 1, whitespace + 1))
+        {
+            *ch = ' ';
+        }
+
+        size_t item = 0;
+        strix_view_t value = {copy, value_len}, item_view;
+        strix_split_iter_t items = strix_split_iter(value, ' ');
+        while (strix_split_next(&items, &item_view))
+        {
+            char *item_str = copy + (item_view.str - copy);
+            item_str[item_view.len] = 0; // the separator after the item, which the iterator is already past
+            list[item++] = item_str;
+        }
+
+        entry->list = list;
+        entry->list_num = item_num;
+    }
+
+    *count = entry->list_num;
+    return entry->list;
+}
+
 void neo_set_global_default_compiler(neocompiler_t compiler)
 {
     GLOBAL_DEFAULT_COMPILER = compiler;
@@ -290,23 +2605,101 @@ neocompiler_t neo_get_global_default_compiler()
     return GLOBAL_DEFAULT_COMPILER;
 }
 
+// the compile command of the previous neo_compile_to_object_file call; consecutive compilations
+// almost always share the compiler and flags, so only the source and output need filling in
+static struct
+{
+    neocompiler_t compiler;
+    char *flags; // NULL if the template has no flags
+    bool has_depfile;
+    neocmd_template_t *cmd_template;
+} compile_cache = {0};
+
+static void compile_cache_clear(void)
+{
+    if (compile_cache.cmd_template)
+    {
+        neocmd_template_delete(compile_cache.cmd_template);
+    }
+    free(compile_cache.flags);
+    compile_cache.cmd_template = NULL;
+    compile_cache.flags = NULL;
+}
+
+static neocmd_template_t *compile_template(neocompiler_t compiler, const char *compiler_flags, bool has_depfile)
+{
+    if (compile_cache.cmd_template && compile_cache.compiler == compiler && compile_cache.has_depfile == has_depfile &&
+        (compiler_flags ? compile_cache.flags && !strcmp(compile_cache.flags, compiler_flags) : !compile_cache.flags))
+    {
+        return compile_cache.cmd_template;
+    }
+
+    const char *prefix;
+    switch (compiler)
+    {
+    case GCC:
+        prefix = "gcc -c";
+        break;
+    case CLANG:
+        prefix = "clang -c";
+        break;
+    case AS:
+        prefix = "as -c";
+        break;
+    default:
+        NEO_LOGF(ERROR, "[%s] Unsupported compiler type: %d", __func__, compiler);
+        return NULL;
+    }
+
+    static bool registered = false;
+    if (!registered)
+    {
+        registered = true;
+        atexit(compile_cache_clear);
+    }
+    compile_cache_clear();
+
+    char *flags = NULL;
+    if (compiler_flags && !(flags = strdup(compiler_flags)))
+    {
+        NEO_LOGF(ERROR, "[%s] Failed duplicating the compiler flags: %s", __func__, strerror(errno));
+        return NULL;
+    }
+
+    // NULL flags end the argument list early, leaving the template without them
+    neocmd_template_t *cmd_template;
+    if (has_depfile)
+    {
+        cmd_template = compiler_flags ? neocmd_template_create(SH, prefix, NEOCMD_SLOT, "-o", NEOCMD_SLOT, compiler_flags, "-MMD -MF", NEOCMD_SLOT)
+                                  : neocmd_template_create(SH, prefix, NEOCMD_SLOT, "-o", NEOCMD_SLOT, "-MMD -MF", NEOCMD_SLOT);
+    }
+    else
+    {
+        cmd_template = neocmd_template_create(SH, prefix, NEOCMD_SLOT, "-o", NEOCMD_SLOT, compiler_flags);
+    }
+
+    if (!cmd_template)
+    {
+        free(flags);
+        return NULL;
+    }
+
+    compile_cache.compiler = compiler;
+    compile_cache.flags = flags;
+    compile_cache.has_depfile = has_depfile;
+    compile_cache.cmd_template = cmd_template;
+    return cmd_template;
+}
+
 // returns true if the compilation was successful, false otherwise
 bool neo_compile_to_object_file(neocompiler_t compiler, const char *source, const char *output, const char *compiler_flags, bool force_compilation)
 {
     if (!source)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Source path cannot be NULL", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Source path cannot be NULL", __func__);
         return false;
     }
 
-    // display force compilation status
-    char force_msg[MAX_TEMP_STRLEN];
-    snprintf(force_msg, sizeof(force_msg), "[%s] Force compilation of %s %s",
-             __func__, source, force_compilation ? "enabled" : "disabled");
-    NEO_LOG(ERROR, force_msg);
-
     char *output_name = NULL;
     bool should_free_output_name = false;
 
@@ -319,78 +2712,21 @@ bool neo_compile_to_object_file(neocompiler_t compiler, const char *source, cons
         size_t source_len = strlen(source);
         output_name = (char *)malloc((source_len + 3) * sizeof(char));
         if (!output_name)
-        {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Allocation for output filename failed: %s", __func__, strerror(errno));
-            NEO_LOG(ERROR, msg);
-            return false;
-        }
-        should_free_output_name = true;
-
-        strcpy(output_name, source);
-        char *extension = strrchr(output_name, '.');
-        if (extension)
-        {
-            strcpy(extension, ".o");
-        }
-        else
-        {
-            strcat(output_name, ".o");
-        }
-    }
-
-    struct stat source_stat;
-    if (stat(source, &source_stat) == -1)
-    {
-        char msg[MAX_TEMP_STRLEN];
-        if (errno == ENOENT)
-        {
-            snprintf(msg, sizeof(msg), "[%s] Source file '%s' not found", __func__, source);
-        }
-        else
-        {
-            snprintf(msg, sizeof(msg), "[%s] Cannot access source file '%s': %s", __func__, source, strerror(errno));
-        }
-        NEO_LOG(ERROR, msg);
-        if (should_free_output_name)
-            free(output_name);
-        return false;
-    }
+        {
+            NEO_LOGF(ERROR, "[%s] Allocation for output filename failed: %s", __func__, strerror(errno));
+            return false;
+        }
+        should_free_output_name = true;
 
-    // if there is no force compilation, do timestamp caching
-    if (!force_compilation)
-    {
-        // check if the output file exists and is older than the source file
-        struct stat output_stat;
-        if (!stat(output_name, &output_stat))
+        strcpy(output_name, source);
+        char *extension = strrchr(output_name, '.');
+        if (extension)
         {
-            if (output_stat.st_mtime >= source_stat.st_mtime)
-            {
-                char msg[MAX_TEMP_STRLEN];
-                snprintf(msg, sizeof(msg), "[%s] Output file '%s' is up to date - skipping compilation", __func__, output_name);
-                NEO_LOG(INFO, msg);
-                if (should_free_output_name)
-                    free(output_name);
-                return true;
-            }
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Source file '%s' is newer than output file - recompiling", __func__, source);
-            NEO_LOG(INFO, msg);
+            strcpy(extension, ".o");
         }
         else
         {
-            if (errno != ENOENT)
-            {
-                char msg[MAX_TEMP_STRLEN];
-                snprintf(msg, sizeof(msg), "[%s] Failed to check output file '%s': %s", __func__, output_name, strerror(errno));
-                NEO_LOG(ERROR, msg);
-                if (should_free_output_name)
-                    free(output_name);
-                return false;
-            }
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Output file '%s' does not exist - will create", __func__, output_name);
-            NEO_LOG(INFO, msg);
+            strcat(output_name, ".o");
         }
     }
 
@@ -399,86 +2735,62 @@ bool neo_compile_to_object_file(neocompiler_t compiler, const char *source, cons
         compiler = neo_get_global_default_compiler();
     }
 
-    neocmd_t *cmd = neocmd_create(SH);
-    if (!cmd)
+    // ninja tracks the headers of a source file through the dependency file the compiler writes
+    strix_t depfile = {0};
+    bool has_depfile = ninja_is_active() && (compiler == GCC || compiler == CLANG);
+    if (has_depfile && !strix_appendf(&depfile, "%s.d", output_name))
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Failed to create command object", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Failed to build the dependency file path of '%s'", __func__, output_name);
         if (should_free_output_name)
             free(output_name);
         return false;
     }
 
-    // if compiler_flags are NULL, they will be skipped anyways since variable argument parsing stops at
-    // the first NULL argument
-    // we technically won't need the macro appending NULL at the end in that case
-    switch (compiler)
-    {
-    case GCC:
-        neocmd_append(cmd, "gcc -c", source, "-o", output_name, compiler_flags);
-        break;
-    case CLANG:
-        neocmd_append(cmd, "clang -c", source, "-o", output_name, compiler_flags);
-        break;
-    case AS:
-        neocmd_append(cmd, "as -c", source, "-o", output_name, compiler_flags);
-        break;
-    default:
+    neocmd_template_t *cmd_template = compile_template(compiler, compiler_flags, has_depfile);
+    if (!cmd_template)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Unsupported compiler type: %d", __func__, compiler);
-        NEO_LOG(ERROR, msg);
-        neocmd_delete(cmd);
+        strix_clear(&depfile);
         if (should_free_output_name)
             free(output_name);
         return false;
     }
-    }
-
-    int status, code;
-    bool result = neocmd_run_sync(cmd, &status, &code, false);
-    if (!result)
-    {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Shell creation for compilation failed\n", __func__);
-        NEO_LOG(ERROR, msg);
-    }
-
-    // the shell process has run, but we don't know if it
-    // ran the command we gave it correctly
-    // knowledge about it is in status and code
 
-    // the exit code of the compilation will be 0 for successfull
-
-    if (!code)
+    neocmd_t *cmd = has_depfile ? neocmd_template_instantiate(cmd_template, source, output_name, strix_str(&depfile))
+                                : neocmd_template_instantiate(cmd_template, source, output_name);
+    if (!cmd)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Compilation failed\n", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Failed to create command object", __func__);
+        strix_clear(&depfile);
+        if (should_free_output_name)
+            free(output_name);
+        return false;
     }
 
-    if (result && code)
-    {
-        // successful compilation
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Compilation successful", __func__);
-        NEO_LOG(INFO, msg);
-    }
+    // will compile only if the output file doesn't exist or if it is older than the source file
+    neostep_t step = {
+        .kind = NEOSTEP_COMPILE,
+        .forced = force_compilation,
+        .restat = restat_enabled,
+        .output = output_name,
+        .inputs = &source,
+        .input_num = 1,
+        .cmd = cmd,
+        .depfile = has_depfile ? strix_str(&depfile) : NULL,
+    };
+    bool result = neostep_execute(&step);
 
     neocmd_delete(cmd);
+    strix_clear(&depfile);
     if (should_free_output_name)
         free(output_name);
-    return (!code ? false : true); // return if the compilation was successful or not
+    return result; // return if the compilation was successful or not
 }
 
-neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
+static neoconfig_t *parse_config(const char *config_file_path, size_t *config_num)
 {
     if (!config_file_path || !config_num)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Arguments invalid", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Arguments invalid", __func__);
         return NULL;
     }
 
@@ -487,9 +2799,7 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
     neoconfig_t *config_arr = (neoconfig_t *)malloc(sizeof(neoconfig_t) * INIT_CONFIG_SIZE);
     if (!config_arr)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Config array allocation failed: %s", __func__, strerror(errno));
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Config array allocation failed: %s", __func__, strerror(errno));
         return NULL;
     }
 
@@ -497,36 +2807,24 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
 #undef INIT_CONFIG_SIZE
 
     size_t curr_index = 0;
-    strix_t *file = conv_file_to_strix(config_file_path);
+    const strix_t *file = strix_map_file(config_file_path);
     if (!file)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] File conversion to strix failed", __func__);
-        NEO_LOG(ERROR, msg);
-        free(config_arr);
-        return NULL;
-    }
-
-    strix_arr_t *arr = strix_split_by_delim(file, ';');
-    if (!arr)
-    {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Config parsing failed", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Failed reading '%s'", __func__, config_file_path);
         free(config_arr);
-        strix_free(file);
         return NULL;
     }
 
-    for (size_t index = 0; index < arr->len; index++)
+    strix_view_t conf;
+    strix_split_iter_t statements = strix_split_iter(strix_view(file), ';');
+    while (strix_split_next(&statements, &conf))
     {
-        strix_t *conf = arr->strix_arr[index];
         size_t eq_index = 0;
         bool found = false;
 
-        for (size_t counter = 0; counter < conf->len; counter++)
+        for (size_t counter = 0; counter < conf.len; counter++)
         {
-            if (conf->str[counter] == '=')
+            if (conf.str[counter] == '=')
             {
                 found = true;
                 eq_index = counter;
@@ -536,25 +2834,23 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
 
         if (!found)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Invalid Config-Value pair: " STRIX_FORMAT, __func__, STRIX_PRINT(conf));
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[%s] Invalid Config-Value pair: " STRIX_FORMAT, __func__, STRIX_PRINT(&conf));
             continue;
         }
 
         size_t key_count = 0;
         for (size_t i = 0; i < eq_index; i++)
         {
-            if (!isspace(conf->str[i]))
+            if (!isspace((unsigned char)conf.str[i]))
             {
                 key_count++;
             }
         }
 
         size_t value_count = 0;
-        for (size_t i = eq_index + 1; i < conf->len; i++)
+        for (size_t i = eq_index + 1; i < conf.len; i++)
         {
-            if (!isspace(conf->str[i]))
+            if (!isspace((unsigned char)conf.str[i]))
             {
                 value_count++;
             }
@@ -568,12 +2864,9 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
                 free(config_arr[i].key);
                 free(config_arr[i].value);
             }
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Config-Value pair allocation failed: %s", __func__, strerror(errno));
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[%s] Config-Value pair allocation failed: %s", __func__, strerror(errno));
             free(config_arr);
-            strix_free(file);
-            strix_free_strix_arr(arr);
+            strix_unmap_file(file);
             return NULL;
         }
 
@@ -585,32 +2878,29 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
                 free(config_arr[i].key);
                 free(config_arr[i].value);
             }
-            char msg[MAX_TEMP_STRLEN];
             free(config_name);
-            snprintf(msg, sizeof(msg), "[%s] Config-Value pair allocation failed: %s", __func__, strerror(errno));
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[%s] Config-Value pair allocation failed: %s", __func__, strerror(errno));
             free(config_arr);
-            strix_free(file);
-            strix_free_strix_arr(arr);
+            strix_unmap_file(file);
             return NULL;
         }
 
         size_t curr = 0;
         for (size_t i = 0; i < eq_index; i++)
         {
-            if (!isspace(conf->str[i]))
+            if (!isspace((unsigned char)conf.str[i]))
             {
-                config_name[curr++] = conf->str[i];
+                config_name[curr++] = conf.str[i];
             }
         }
         config_name[curr] = 0;
 
         curr = 0;
-        for (size_t i = eq_index + 1; i < conf->len; i++)
+        for (size_t i = eq_index + 1; i < conf.len; i++)
         {
-            if (!isspace(conf->str[i]))
+            if (!isspace((unsigned char)conf.str[i]))
             {
-                value[curr++] = conf->str[i];
+                value[curr++] = conf.str[i];
             }
         }
         value[curr] = 0;
@@ -621,9 +2911,7 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
             neoconfig_t *temp = (neoconfig_t *)realloc(config_arr, sizeof(neoconfig_t) * new_cap);
             if (!temp)
             {
-                char msg[MAX_TEMP_STRLEN];
-                snprintf(msg, sizeof(msg), "[%s] Config array reallocation failed: %s", __func__, strerror(errno));
-                NEO_LOG(ERROR, msg);
+                NEO_LOGF(ERROR, "[%s] Config array reallocation failed: %s", __func__, strerror(errno));
                 free(config_name);
                 free(value);
 
@@ -634,8 +2922,7 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
                     free(config_arr[i].value);
                 }
                 free(config_arr);
-                strix_free(file);
-                strix_free_strix_arr(arr);
+                strix_unmap_file(file);
                 return NULL;
             }
             config_arr = temp;
@@ -649,8 +2936,7 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
 
     *config_num = curr_index;
 
-    strix_free_strix_arr(arr);
-    strix_free(file);
+    strix_unmap_file(file);
 
     if (!curr_index)
     {
@@ -668,13 +2954,19 @@ neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
     return final_config;
 }
 
+neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_num)
+{
+    uint64_t start = neostats_begin();
+    neoconfig_t *config_arr = parse_config(config_file_path, config_num);
+    neostats_end(NEOSTAT_PARSE_CONFIG, start);
+    return config_arr;
+}
+
 bool neo_mkdir(const char *dir_path, mode_t dir_mode)
 {
     if (!dir_path)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[%s] Argument dir_path is invalid", __func__);
-        NEO_LOG(ERROR, msg);
+        NEO_LOGF(ERROR, "[%s] Argument dir_path is invalid", __func__);
         return false;
     }
 
@@ -682,9 +2974,7 @@ bool neo_mkdir(const char *dir_path, mode_t dir_mode)
     {
         if (mkdir(dir_path, 0777) == -1)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Creating dir %s failed", __func__, dir_path);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[%s] Creating dir %s failed", __func__, dir_path);
             return false;
         }
     }
@@ -692,9 +2982,7 @@ bool neo_mkdir(const char *dir_path, mode_t dir_mode)
     {
         if (mkdir(dir_path, dir_mode) == -1)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[%s] Creating dir %s failed", __func__, dir_path);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[%s] Creating dir %s failed", __func__, dir_path);
             return false;
         }
     }
@@ -722,18 +3010,14 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
 
     if (!build_file_c)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neorebuild] Build file pointer is NULL");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neorebuild] Build file pointer is NULL");
         return false;
     }
 
     struct stat build_file_c_stat;
     if (stat(build_file_c, &build_file_c_stat))
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neorebuild] Failed getting file stats for %s: %s", build_file_c, strerror(errno));
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neorebuild] Failed getting file stats for %s: %s", build_file_c, strerror(errno));
         return false;
     }
 
@@ -741,9 +3025,7 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
     char *build_file = (char *)malloc((build_file_len + 1) * sizeof(char));
     if (!build_file)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neorebuild] Memory allocation failed: %s", strerror(errno));
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neorebuild] Memory allocation failed: %s", strerror(errno));
         return false;
     }
 
@@ -762,44 +3044,40 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
     struct stat build_file_stat;
     if (stat(build_file, &build_file_stat))
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neorebuild] Failed getting file stats for %s: %s", build_file, strerror(errno));
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neorebuild] Failed getting file stats for %s: %s", build_file, strerror(errno));
         free(build_file);
         return false;
     }
 
     if (build_file_stat.st_mtime < build_file_c_stat.st_mtime)
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[neorebuild] The build file %s was modified since it was last built", build_file_c);
-        NEO_LOG(INFO, msg);
+        NEO_LOGF(INFO, "[neorebuild] The build file %s was modified since it was last built", build_file_c);
 
-        snprintf(msg, sizeof(msg), "[neorebuild] Rebuilding %s", build_file_c);
-        NEO_LOG(INFO, msg);
+        NEO_LOGF(INFO, "[neorebuild] Rebuilding %s", build_file_c);
 
-        char cmd[MAX_TEMP_STRLEN];
-        snprintf(cmd, sizeof(cmd), "./buildneo %s", build_file_c);
-        NEO_LOG(INFO, cmd);
+        strix_t cmd = {0};
+        bool built = strix_appendf(&cmd, "./buildneo %s", build_file_c);
+        if (built)
+        {
+            NEO_LOGF(INFO, "%s", strix_str(&cmd));
+        }
 
-        if (system(cmd) == -1)
+        if (!built || system(strix_str(&cmd)) == -1)
         {
-            snprintf(msg, sizeof(msg), "[neorebuild] Rebuilding %s failed: %s", build_file_c, strerror(errno));
-            NEO_LOG(ERROR, msg);
-            snprintf(msg, sizeof(msg), "[neorebuild] Running the old version of %s", build_file);
-            NEO_LOG(INFO, msg);
+            NEO_LOGF(ERROR, "[neorebuild] Rebuilding %s failed: %s", build_file_c, strerror(errno));
+            NEO_LOGF(INFO, "[neorebuild] Running the old version of %s", build_file);
+            strix_clear(&cmd);
             free(build_file);
             return false;
         }
+        strix_clear(&cmd);
 
-        snprintf(msg, sizeof(msg), "[neorebuild] Running the new version of %s and exiting the current running version", build_file);
-        NEO_LOG(INFO, msg);
+        NEO_LOGF(INFO, "[neorebuild] Running the new version of %s and exiting the current running version", build_file);
 
         neocmd_t *neo = neocmd_create(SH);
         if (!neo)
         {
-            snprintf(msg, sizeof(msg), "[neorebuild] Failed running the new version of %s; Continuing with the current running version: %s", build_file, strerror(errno));
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neorebuild] Failed running the new version of %s; Continuing with the current running version: %s", build_file, strerror(errno));
             free(build_file);
             return false;
         }
@@ -807,13 +3085,15 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
         neocmd_append(neo, "./neo");
 
         char **arg_ptr = argv;
-        char buf[2048] = {0};
         arg_ptr++; // skip program name
         while (*arg_ptr)
         {
-            char *str = *arg_ptr;
-            snprintf(buf, sizeof(buf) - 1, "\"%s\"", str);
-            neocmd_append(neo, buf);
+            strix_t quoted = {0};
+            if (strix_appendf(&quoted, "\"%s\"", *arg_ptr))
+            {
+                neocmd_append(neo, strix_str(&quoted));
+            }
+            strix_clear(&quoted);
             arg_ptr++;
         }
 
@@ -821,8 +3101,7 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
 
         if (!neocmd_run_sync(neo, NULL, NULL, false))
         {
-            snprintf(msg, sizeof(msg), "[neorebuild] Failed running the new version of %s; Continuing with the current running version: %s", build_file, strerror(errno));
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neorebuild] Failed running the new version of %s; Continuing with the current running version: %s", build_file, strerror(errno));
             free(build_file);
             neocmd_delete(neo);
             return false;
@@ -835,90 +3114,92 @@ bool neorebuild(const char *build_file_c, char **argv, int *argc)
     }
     else
     {
-        char msg[MAX_TEMP_STRLEN];
-        snprintf(msg, sizeof(msg), "[neorebuild] No rebuild required for %s (not modified)", build_file_c);
-        NEO_LOG(INFO, msg);
+        NEO_LOGF(INFO, "[neorebuild] No rebuild required for %s (not modified)", build_file_c);
     }
 
     free(build_file);
     return true;
 }
 
-const char *neocmd_render(neocmd_t *neocmd)
+static inline size_t *neocmd_offsets(const neocmd_t *neocmd)
+{
+    return neocmd->offsets ? neocmd->offsets : (size_t *)neocmd->inline_offsets;
+}
+
+static inline char *neocmd_arena(const neocmd_t *neocmd)
+{
+    return neocmd->arena ? neocmd->arena : (char *)neocmd->inline_arena;
+}
+
+size_t neocmd_render_len(const neocmd_t *neocmd)
+{
+    return neocmd ? neocmd->arena_len : 0;
+}
+
+size_t neocmd_render_into(const neocmd_t *neocmd, char *buffer, size_t size)
 {
-    if (!neocmd || !neocmd->args)
+    if (!neocmd)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Invalid neocmd or args pointer");
-        NEO_LOG(ERROR, error_msg);
-        return NULL;
+        NEO_LOGF(ERROR, "[%s] Invalid neocmd pointer", __func__);
+        if (buffer && size)
+        {
+            buffer[0] = 0;
+        }
+        return 0;
     }
 
-    strix_t *strix = strix_create_empty();
-    if (!strix)
+    if (!buffer || !size)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Failed to create empty strix");
-        NEO_LOG(ERROR, error_msg);
-        return NULL;
+        return neocmd->arena_len;
     }
 
-    dyn_arr_t *arr = neocmd->args;
-    int64_t last = arr->last_index;
-
-    for (int64_t index = 0; index <= last; index++)
+    // the arena already holds the arguments in order, each followed by its NUL terminator;
+    // the rendered command is the arena with every terminator turned into the separating space
+    size_t len = neocmd->arena_len < size - 1 ? neocmd->arena_len : size - 1;
+    const char *arena = neocmd_arena(neocmd);
+    for (size_t index = 0; index < len; index++)
     {
-        strix_t *temp;
-        if (!dyn_arr_get(arr, index, &temp))
-        {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Failed to get item at index %ld", index);
-            NEO_LOG(ERROR, error_msg);
-            strix_free(strix);
-            return NULL;
-        }
+        buffer[index] = arena[index] ? arena[index] : ' ';
+    }
+    buffer[len] = 0;
 
-        if (!strix_concat(strix, temp))
-        {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Failed to concatenate strix at index %ld", index);
-            NEO_LOG(ERROR, error_msg);
-            strix_free(strix);
-            return NULL;
-        }
+    return neocmd->arena_len;
+}
 
-        if (!strix_append(strix, " "))
-        {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Failed to append space after index %ld", index);
-            NEO_LOG(ERROR, error_msg);
-            strix_free(strix);
-            return NULL;
-        }
+static const char *render_command(neocmd_t *neocmd)
+{
+    if (!neocmd)
+    {
+        NEO_LOGF(ERROR, "[neocmd_render] Invalid neocmd pointer");
+        return NULL;
     }
 
-    char *str = strix_to_cstr(strix);
+    size_t len = neocmd_render_len(neocmd);
+    char *str = (char *)malloc(len + 1);
     if (!str)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_render] Failed to convert strix to C string");
-        NEO_LOG(ERROR, error_msg);
-        strix_free(strix);
+        NEO_LOGF(ERROR, "[neocmd_render] Failed to allocate the rendered command: %s", strerror(errno));
         return NULL;
     }
 
-    strix_free(strix);
+    neocmd_render_into(neocmd, str, len + 1);
     return (const char *)str;
 }
 
+const char *neocmd_render(neocmd_t *neocmd)
+{
+    uint64_t start = neostats_begin();
+    const char *command = render_command(neocmd);
+    neostats_end(NEOSTAT_RENDER, start);
+    return command;
+}
+
 bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
 {
     // check for invalid arguments
     if (pid < 0)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neoshell_wait] Invalid pid: %d", pid);
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neoshell_wait] Invalid pid: %d", pid);
         return false;
     }
 
@@ -928,13 +3209,14 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
 
     siginfo_t info;
     // wait for the child process with the given pid to exit or stop
-    if (waitid(P_PID, (id_t)pid, &info, WEXITED | WSTOPPED) == -1)
+    uint64_t start = neostats_begin();
+    int result = waitid(P_PID, (id_t)pid, &info, WEXITED | WSTOPPED);
+    neostats_end(NEOSTAT_WAIT, start);
+    if (result == -1)
     {
         if (should_print)
         {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neoshell_wait] waitid on pid %d failed: %s", pid, strerror(errno));
-            NEO_LOG(ERROR, error_msg);
+            NEO_LOGF(ERROR, "[neoshell_wait] waitid on pid %d failed: %s", pid, strerror(errno));
         }
         return false;
     }
@@ -957,9 +3239,7 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // child exited normally, store the exit status
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d exited normally with status %d", pid, info.si_status);
-            NEO_LOG(INFO, msg);
+            NEO_LOGF(INFO, "[neoshell_wait] shell process %d exited normally with status %d", pid, info.si_status);
         }
         break;
 
@@ -967,9 +3247,7 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // child was killed by a signal
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d was killed by signal %d", pid, info.si_status);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neoshell_wait] shell process %d was killed by signal %d", pid, info.si_status);
         }
         break;
 
@@ -977,9 +3255,7 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // child was killed by a signal and dumped core
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d was killed by signal %d (core dumped)", pid, info.si_status);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neoshell_wait] shell process %d was killed by signal %d (core dumped)", pid, info.si_status);
         }
         break;
 
@@ -987,9 +3263,7 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // child was stopped by a signal
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d was stopped by signal %d", pid, info.si_status);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neoshell_wait] shell process %d was stopped by signal %d", pid, info.si_status);
         }
         break;
 
@@ -997,9 +3271,7 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // traced child has trapped (e.g., during debugging)
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d was trapped by signal %d (traced child)", pid, info.si_status);
-            NEO_LOG(ERROR, msg);
+            NEO_LOGF(ERROR, "[neoshell_wait] shell process %d was trapped by signal %d (traced child)", pid, info.si_status);
         }
         break;
 
@@ -1007,10 +3279,8 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print)
         // unknown or unexpected termination reason
         if (should_print)
         {
-            char msg[MAX_TEMP_STRLEN];
-            snprintf(msg, sizeof(msg), "[neoshell_wait] shell process %d terminated in an unknown way (si_code: %d, si_status: %d)",
+            NEO_LOGF(ERROR, "[neoshell_wait] shell process %d terminated in an unknown way (si_code: %d, si_status: %d)",
                      pid, info.si_code, info.si_status);
-            NEO_LOG(ERROR, msg);
         }
         return false;
     }
@@ -1048,33 +3318,30 @@ pid_t neocmd_run_async(neocmd_t *neocmd)
 
     if (!neocmd)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async] Invalid neocmd pointer");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_run_async] Invalid neocmd pointer");
         return -1;
     }
 
     const char *command = neocmd_render(neocmd);
     if (!command)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async] Failed to render command");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_run_async] Failed to render command");
         return -1;
     }
 
-    char msg[512];
-    snprintf(msg, sizeof(msg), "[neocmd_run_async] %s", command);
-    NEO_LOG(INFO, msg); // display the command being run by the newly created shell
+    NEO_LOGF(INFO, "[neocmd_run_async] %s", command); // display the command being run by the newly created shell
 
+    uint64_t start = neostats_begin();
     pid_t child = fork();
+    if (child)
+    {
+        neostats_end(NEOSTAT_SPAWN, start);
+    }
 
     if (child == -1)
     {
         // no child process is created
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async] Child process could not be forked: %s", strerror(errno));
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_run_async] Child process could not be forked: %s", strerror(errno));
         free((void *)command);
         return -1;
     }
@@ -1088,42 +3355,28 @@ pid_t neocmd_run_async(neocmd_t *neocmd)
             char *argv[4] = {"/bin/bash", "-c", (char *)command, NULL}; // NULL marks the end of the argv array
             // the output of the command will be displayed in the shell running the neocmd_run function
             // since the stdout of the child and parent refer to the same open file description
-            if (execv("/bin/bash", argv) == -1)
-            {
-                char error_msg[MAX_TEMP_STRLEN];
-                snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
-                NEO_LOG(ERROR, error_msg);
-                free((void *)command);
-                return EXIT_FAILURE;
-            }
+            // execv only returns on failure; the child mustn't return into the caller's code (or run its atexit handlers)
+            execv("/bin/bash", argv);
+            NEO_LOGF(ERROR, "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
+            _exit(127);
         }
         case SH:
         {
             char *argv[4] = {"/bin/sh", "-c", (char *)command, NULL}; // NULL marks the end of the argv array
             // the output of the command will be displayed in the shell running the neocmd_run function
             // since the stdout of the child and parent refer to the same open file description
-            if (execv("/bin/sh", argv) == -1)
-            {
-                char error_msg[MAX_TEMP_STRLEN];
-                snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
-                NEO_LOG(ERROR, error_msg);
-                free((void *)command);
-                return EXIT_FAILURE;
-            }
+            execv("/bin/sh", argv);
+            NEO_LOGF(ERROR, "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
+            _exit(127);
         }
         case DASH:
         {
             char *argv[4] = {"/bin/dash", "-c", (char *)command, NULL}; // NULL marks the end of the argv array
             // the output of the command will be displayed in the shell running the neocmd_run function
             // since the stdout of the child and parent refer to the same open file description
-            if (execv("/bin/dash", argv) == -1)
-            {
-                char error_msg[MAX_TEMP_STRLEN];
-                snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
-                NEO_LOG(ERROR, error_msg);
-                free((void *)command);
-                return EXIT_FAILURE;
-            }
+            execv("/bin/dash", argv);
+            NEO_LOGF(ERROR, "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
+            _exit(127);
         }
         default:
         {
@@ -1131,14 +3384,9 @@ pid_t neocmd_run_async(neocmd_t *neocmd)
             char *argv[4] = {"/bin/bash", "-c", (char *)command, NULL}; // NULL marks the end of the argv array
             // the output of the command will be displayed in the shell running the neocmd_run function
             // since the stdout of the child and parent refer to the same open file description
-            if (execv("/bin/bash", argv) == -1)
-            {
-                char error_msg[MAX_TEMP_STRLEN];
-                snprintf(error_msg, sizeof(error_msg), "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
-                NEO_LOG(ERROR, error_msg);
-                free((void *)command);
-                return EXIT_FAILURE;
-            }
+            execv("/bin/bash", argv);
+            NEO_LOGF(ERROR, "[neocmd_run_async:child] Child shell could not be executed: %s", strerror(errno));
+            _exit(127);
         }
         }
     }
@@ -1166,9 +3414,7 @@ bool neocmd_run_sync(neocmd_t *neocmd, int *status, int *code, bool print_status
     pid_t child = neocmd_run_async(neocmd);
     if (child == -1)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_run_sync] Failed to run command asynchronously");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_run_sync] Failed to run command asynchronously");
         return false;
     }
 
@@ -1184,23 +3430,16 @@ neocmd_t *neocmd_create(neoshell_t shell)
     neocmd_t *neocmd = (neocmd_t *)malloc(sizeof(neocmd_t));
     if (!neocmd)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_create] Failed to allocate memory for neocmd");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_create] Failed to allocate memory for neocmd");
         return NULL;
     }
 
-#define MIN_ARG_NUM 16
-    neocmd->args = dyn_arr_create(MIN_ARG_NUM, sizeof(strix_t *), NULL);
-#undef MIN_ARG_NUM
-    if (!neocmd->args)
-    {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_create] Failed to create dynamic array for arguments");
-        NEO_LOG(ERROR, error_msg);
-        free(neocmd);
-        return NULL;
-    }
+    neocmd->offsets = NULL;
+    neocmd->arena = NULL;
+    neocmd->arg_num = 0;
+    neocmd->offset_capacity = NEOCMD_INLINE_ARGS;
+    neocmd->arena_len = 0;
+    neocmd->arena_capacity = NEOCMD_INLINE_ARENA;
     neocmd->shell = shell;
 
     return neocmd;
@@ -1208,62 +3447,338 @@ neocmd_t *neocmd_create(neoshell_t shell)
 
 bool neocmd_delete(neocmd_t *neocmd)
 {
-    if (!neocmd || !neocmd->args)
+    if (!neocmd)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_delete] Invalid neocmd or args pointer");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_delete] Invalid neocmd pointer");
         return false;
     }
 
-    cleanup_arg_array(neocmd->args);
-
-    dyn_arr_free(neocmd->args);
+    free(neocmd->offsets);
+    free(neocmd->arena);
     free((void *)neocmd);
 
     return true;
 }
 
+// makes room for arg_num more arguments taking bytes more arena bytes (NUL terminators included)
+static bool neocmd_reserve(neocmd_t *neocmd, size_t arg_num, size_t bytes)
+{
+    size_t needed_args = neocmd->arg_num + arg_num;
+    if (needed_args > neocmd->offset_capacity)
+    {
+        size_t capacity = neocmd->offset_capacity * 2;
+        while (capacity < needed_args)
+        {
+            capacity *= 2;
+        }
+
+        size_t *offsets = (size_t *)realloc(neocmd->offsets, capacity * sizeof(size_t));
+        if (!offsets)
+        {
+            return false;
+        }
+
+        if (!neocmd->offsets)
+        {
+            memcpy(offsets, neocmd->inline_offsets, neocmd->arg_num * sizeof(size_t));
+        }
+        neocmd->offsets = offsets;
+        neocmd->offset_capacity = capacity;
+    }
+
+    size_t needed = neocmd->arena_len + bytes;
+    if (needed > neocmd->arena_capacity)
+    {
+        size_t capacity = neocmd->arena_capacity * 2;
+        while (capacity < needed)
+        {
+            capacity *= 2;
+        }
+
+        char *arena = (char *)realloc(neocmd->arena, capacity);
+        if (!arena)
+        {
+            return false;
+        }
+
+        if (!neocmd->arena)
+        {
+            memcpy(arena, neocmd->inline_arena, neocmd->arena_len);
+        }
+        neocmd->arena = arena;
+        neocmd->arena_capacity = capacity;
+    }
+
+    return true;
+}
+
 bool neocmd_append_null(neocmd_t *neocmd, ...)
 {
-    if (!neocmd || !neocmd->args)
+    if (!neocmd)
     {
-        char error_msg[MAX_TEMP_STRLEN];
-        snprintf(error_msg, sizeof(error_msg), "[neocmd_append_null] Invalid neocmd or args pointer");
-        NEO_LOG(ERROR, error_msg);
+        NEO_LOGF(ERROR, "[neocmd_append_null] Invalid neocmd pointer");
         return false;
     }
 
     va_list args;
     va_start(args, neocmd); // the variadic arguments start after the parameter neocmd; initialize the list with the last static arguments
-    dyn_arr_t *neocmd_args = neocmd->args;
+
+    size_t arg_num = neocmd->arg_num;
+    size_t arena_len = neocmd->arena_len;
 
     const char *arg = va_arg(args, const char *);
     while (arg)
     {
-        strix_t *arg_strix = strix_create(arg);
-        if (!arg_strix)
+        size_t len = strlen(arg);
+        if (!neocmd_reserve(neocmd, 1, len + 1))
         {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neocmd_append_null] Failed to create strix for argument: %s", arg);
-            NEO_LOG(ERROR, error_msg);
-            cleanup_arg_array(neocmd_args);
+            NEO_LOGF(ERROR, "[neocmd_append_null] Failed to make room for argument: %s", arg);
+
+            // leave the command as it was before the call
+            neocmd->arg_num = arg_num;
+            neocmd->arena_len = arena_len;
             va_end(args);
             return false;
         }
 
-        if (!dyn_arr_append(neocmd_args, &arg_strix))
+        neocmd_offsets(neocmd)[neocmd->arg_num++] = neocmd->arena_len;
+        memcpy(neocmd_arena(neocmd) + neocmd->arena_len, arg, len + 1);
+        neocmd->arena_len += len + 1;
+
+        arg = va_arg(args, const char *);
+    }
+
+    va_end(args); // finished extracting all variadic arguments; cleanup
+    return true;
+}
+
+// appends the len bytes at arg as a single argument
+static bool neocmd_append_len(neocmd_t *neocmd, const char *arg, size_t len)
+{
+    if (!neocmd_reserve(neocmd, 1, len + 1))
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to make room for an argument of %zu bytes", __func__, len);
+        return false;
+    }
+
+    char *arena = neocmd_arena(neocmd);
+    neocmd_offsets(neocmd)[neocmd->arg_num++] = neocmd->arena_len;
+    memcpy(arena + neocmd->arena_len, arg, len);
+    arena[neocmd->arena_len + len] = 0;
+    neocmd->arena_len += len + 1;
+    return true;
+}
+
+size_t neocmd_arg_num(const neocmd_t *neocmd)
+{
+    return neocmd ? neocmd->arg_num : 0;
+}
+
+const char *neocmd_arg(const neocmd_t *neocmd, size_t index)
+{
+    if (!neocmd || index >= neocmd->arg_num)
+    {
+        return NULL;
+    }
+
+    return neocmd_arena(neocmd) + neocmd_offsets(neocmd)[index];
+}
+
+const char neocmd_slot[] = "<slot>";
+
+struct neocmd_template
+{
+    neocmd_t *fixed; // every argument of the template, with an empty argument in place of each slot
+    size_t *slots;   // indices of the slot arguments, ascending
+    size_t slot_num;
+};
+
+neocmd_template_t *neocmd_template_create_null(neoshell_t shell, ...)
+{
+    neocmd_template_t *cmd_template = (neocmd_template_t *)calloc(1, sizeof(neocmd_template_t));
+    if (!cmd_template)
+    {
+        NEO_LOGF(ERROR, "[%s] Failed to allocate memory for the template: %s", __func__, strerror(errno));
+        return NULL;
+    }
+
+    cmd_template->fixed = neocmd_create(shell);
+    if (!cmd_template->fixed)
+    {
+        free(cmd_template);
+        return NULL;
+    }
+
+    va_list args;
+    va_start(args, shell);
+
+    const char *arg = va_arg(args, const char *);
+    while (arg)
+    {
+        if (arg == NEOCMD_SLOT)
+        {
+            size_t *slots = (size_t *)realloc(cmd_template->slots, (cmd_template->slot_num + 1) * sizeof(size_t));
+            if (!slots)
+            {
+                NEO_LOGF(ERROR, "[%s] Failed to allocate memory for the slots: %s", __func__, strerror(errno));
+                va_end(args);
+                neocmd_template_delete(cmd_template);
+                return NULL;
+            }
+            cmd_template->slots = slots;
+            cmd_template->slots[cmd_template->slot_num++] = cmd_template->fixed->arg_num;
+            arg = "";
+        }
+
+        if (!neocmd_append(cmd_template->fixed, arg))
         {
-            char error_msg[MAX_TEMP_STRLEN];
-            snprintf(error_msg, sizeof(error_msg), "[neocmd_append_null] Failed to append argument to array: %s", arg);
-            NEO_LOG(ERROR, error_msg);
-            APPEND_CLEANUP(neocmd_args);
+            va_end(args);
+            neocmd_template_delete(cmd_template);
+            return NULL;
         }
+
         arg = va_arg(args, const char *);
     }
 
-    va_end(args); // finished extracting all variadic arguments; cleanup
+    va_end(args);
+    return cmd_template;
+}
+
+bool neocmd_template_delete(neocmd_template_t *cmd_template)
+{
+    if (!cmd_template)
+    {
+        NEO_LOGF(ERROR, "[%s] Invalid template pointer", __func__);
+        return false;
+    }
+
+    if (cmd_template->fixed)
+    {
+        neocmd_delete(cmd_template->fixed);
+    }
+    free(cmd_template->slots);
+    free(cmd_template);
+
     return true;
 }
 
+size_t neocmd_template_slot_num(const neocmd_template_t *cmd_template)
+{
+    return cmd_template ? cmd_template->slot_num : 0;
+}
+
+// builds the command of template with the slots filled by values (of lengths lens)
+static neocmd_t *template_fill(const neocmd_template_t *cmd_template, const char **values, const size_t *lens, size_t arena_len)
+{
+    neocmd_t *neocmd = neocmd_create(cmd_template->fixed->shell);
+    if (!neocmd)
+    {
+        return NULL;
+    }
+
+    // one exact reservation; the fixed arguments between two slots are then copied with a single memcpy
+    if (!neocmd_reserve(neocmd, cmd_template->fixed->arg_num, arena_len))
+    {
+        NEO_LOGF(ERROR, "[neocmd_template_instantiate_null] Failed to make room for the command: %s", strerror(errno));
+        neocmd_delete(neocmd);
+        return NULL;
+    }
+
+    const size_t *fixed_offsets = neocmd_offsets(cmd_template->fixed);
+    const char *fixed_arena = neocmd_arena(cmd_template->fixed);
+    size_t *offsets = neocmd_offsets(neocmd);
+    char *arena = neocmd_arena(neocmd);
+
+    size_t arg = 0;
+    size_t shift = 0; // how far the arguments after the filled slots moved
+    for (size_t slot = 0; slot <= cmd_template->slot_num; slot++)
+    {
+        size_t end = slot < cmd_template->slot_num ? cmd_template->slots[slot] : cmd_template->fixed->arg_num;
+        if (end > arg)
+        {
+            size_t from = fixed_offsets[arg];
+            size_t to = end < cmd_template->fixed->arg_num ? fixed_offsets[end] : cmd_template->fixed->arena_len;
+            memcpy(arena + from + shift, fixed_arena + from, to - from);
+            for (; arg < end; arg++)
+            {
+                offsets[arg] = fixed_offsets[arg] + shift;
+            }
+        }
+
+        if (slot < cmd_template->slot_num)
+        {
+            offsets[arg] = fixed_offsets[arg] + shift;
+            memcpy(arena + offsets[arg], values[slot], lens[slot] + 1);
+            shift += lens[slot];
+            arg++;
+        }
+    }
+
+    neocmd->arg_num = cmd_template->fixed->arg_num;
+    neocmd->arena_len = arena_len;
+    return neocmd;
+}
+
+neocmd_t *neocmd_template_instantiate_null(const neocmd_template_t *cmd_template, ...)
+{
+    if (!cmd_template)
+    {
+        NEO_LOGF(ERROR, "[%s] Invalid template pointer", __func__);
+        return NULL;
+    }
+
+#define MAX_INLINE_SLOTS (8)
+    // the lengths are needed twice; templates rarely have more slots than this
+    size_t inline_lens[MAX_INLINE_SLOTS];
+    const char *inline_values[MAX_INLINE_SLOTS];
+    size_t *lens = inline_lens;
+    const char **values = inline_values;
+    if (cmd_template->slot_num > MAX_INLINE_SLOTS)
+    {
+        lens = (size_t *)malloc(cmd_template->slot_num * (sizeof(size_t) + sizeof(const char *)));
+        if (!lens)
+        {
+            NEO_LOGF(ERROR, "[%s] Failed to allocate memory for the slot values: %s", __func__, strerror(errno));
+            return NULL;
+        }
+        values = (const char **)(lens + cmd_template->slot_num);
+    }
+#undef MAX_INLINE_SLOTS
+
+    va_list args;
+    va_start(args, cmd_template);
+
+    size_t value_num = 0;
+    size_t arena_len = cmd_template->fixed->arena_len;
+    const char *value;
+    while ((value = va_arg(args, const char *)))
+    {
+        if (value_num < cmd_template->slot_num)
+        {
+            values[value_num] = value;
+            lens[value_num] = strlen(value);
+            arena_len += lens[value_num];
+        }
+        value_num++;
+    }
+
+    va_end(args);
+
+    neocmd_t *neocmd = NULL;
+    if (value_num != cmd_template->slot_num)
+    {
+        NEO_LOGF(ERROR, "[%s] The template has %zu slots but %zu values were given", __func__, cmd_template->slot_num, value_num);
+    }
+    else
+    {
+        neocmd = template_fill(cmd_template, values, lens, arena_len);
+    }
+
+    if (lens != inline_lens)
+    {
+        free(lens);
+    }
+    return neocmd;
+}
+
 #undef MAX_TEMP_STRLEN
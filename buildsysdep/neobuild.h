@@ -37,6 +37,58 @@ void neo_set_global_default_compiler(neocompiler_t compiler);
  */
 neocompiler_t neo_get_global_default_compiler();
 
+/**
+ * Enables or disables restat for the build steps executed after this call.
+ *
+ * When restat is enabled, the output of a step that is rebuilt but comes out byte for byte
+ * identical keeps its previous timestamp, so the steps depending on it are not rebuilt.
+ * Output hashes and timestamps are remembered across runs in a .neostate file in the
+ * current directory.
+ *
+ * @param restat true to enable restat, false to disable it (the default).
+ */
+void neo_set_restat(bool restat);
+
+/**
+ * Gets the current restat setting.
+ *
+ * @return true if restat is enabled, false otherwise.
+ */
+bool neo_get_restat(void);
+
+/**
+ * Adds an environment variable to the signature of every build step.
+ *
+ * Each output remembers a signature of the command that built it (as rendered by neocmd_render)
+ * and of the environment variables that influence the toolchain (CPATH, C_INCLUDE_PATH,
+ * CPLUS_INCLUDE_PATH, LIBRARY_PATH, GCC_EXEC_PREFIX, COMPILER_PATH and SOURCE_DATE_EPOCH).
+ * Whenever the signature changes, the output is rebuilt even if it is newer than its inputs.
+ * Signatures are kept in the same .neostate file as the restat data.
+ *
+ * @param name Name of the environment variable (copied).
+ * @return true on success, false otherwise.
+ */
+bool neo_add_signature_env(const char *name);
+
+/**
+ * Sets the command length above which link and archive steps pass their object files through
+ * a response file (@<output>.rsp) instead of the command line.
+ *
+ * The response file is rewritten only when its content changes. GCC, Clang, ld and ar all
+ * read response files. The default is 32 KiB; the command given to the shell can't exceed
+ * 128 KiB on Linux.
+ *
+ * @param threshold The length in bytes; SIZE_MAX disables response files.
+ */
+void neo_set_rsp_threshold(size_t threshold);
+
+/**
+ * Gets the command length above which response files are used.
+ *
+ * @return The current threshold in bytes.
+ */
+size_t neo_get_rsp_threshold(void);
+
 /**
  * Enum representing different logging levels for the neo build system.
  */
@@ -57,34 +109,91 @@ typedef struct
     char *value; /**< Configuration value */
 } neoconfig_t;
 
+#ifndef NEO_LOG_COMPILE_LEVEL
+/**
+ * The most verbose log level compiled into the program.
+ *
+ * Log calls of a more verbose level are removed at compile time, including the formatting
+ * of their arguments. Define it before including neobuild.h (for example with
+ * -DNEO_LOG_COMPILE_LEVEL=WARNING) to strip INFO and DEBUG messages from a build.
+ */
+#define NEO_LOG_COMPILE_LEVEL DEBUG
+#endif
+
+/**
+ * The most verbose log level printed at runtime (INFO by default).
+ * Use neo_set_log_level to change it.
+ */
+extern neolog_level_t neo_log_runtime_level;
+
+/**
+ * Sets the most verbose log level printed at runtime.
+ *
+ * @param level The log level; messages more verbose than it are neither formatted nor printed.
+ */
+void neo_set_log_level(neolog_level_t level);
+
+/**
+ * Gets the most verbose log level printed at runtime.
+ *
+ * @return The current runtime log level.
+ */
+neolog_level_t neo_get_log_level(void);
+
+/**
+ * Formats and prints a log message; ERROR and WARNING messages go to stderr, INFO and DEBUG
+ * messages to stdout. Prefer NEO_LOGF, which skips the call entirely for filtered levels.
+ *
+ * @param level The log level for the message.
+ * @param format A printf style format string, followed by its arguments.
+ */
+void neo_logf(neolog_level_t level, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * Starts a background thread which writes the log messages, so that logging threads only
+ * format their message into a lock-free ring buffer. Messages longer than a ring slot
+ * (1024 bytes including the level prefix) are truncated. A full ring makes loggers wait
+ * for the writer instead of dropping messages.
+ *
+ * The writer is stopped automatically at exit; child processes created with fork log
+ * synchronously.
+ *
+ * @param capacity Number of messages the ring can hold (rounded up to a power of two; 0 for the default of 1024).
+ * @return true if the writer is running, false otherwise.
+ */
+bool neo_log_async_start(size_t capacity);
+
+/**
+ * Writes out every pending log message and stops the background writer thread.
+ * Logging continues synchronously afterwards.
+ */
+void neo_log_async_stop(void);
+
+/**
+ * Macro for logging printf style messages with the specified log level.
+ *
+ * The arguments are evaluated and formatted only if the level passes both the compile time
+ * level (NEO_LOG_COMPILE_LEVEL) and the runtime level (neo_set_log_level).
+ *
+ * @param level The log level for the message (ERROR, WARNING, INFO, or DEBUG).
+ * @param ... A printf style format string, followed by its arguments.
+ */
+#define NEO_LOGF(level, ...)                                                      \
+    do                                                                            \
+    {                                                                             \
+        if ((level) <= NEO_LOG_COMPILE_LEVEL && (level) <= neo_log_runtime_level) \
+        {                                                                         \
+            neo_logf((level), __VA_ARGS__);                                       \
+        }                                                                         \
+    } while (0)
+
 /**
  * Macro for logging messages with the specified log level.
  *
  * @param level The log level for the message (ERROR, WARNING, INFO, or DEBUG).
  * @param msg The message to log.
  */
-#define NEO_LOG(level, msg)                         \
-    do                                              \
-    {                                               \
-        switch (level)                              \
-        {                                           \
-        case ERROR:                                 \
-            fprintf(stderr, "[ERROR] %s\n", msg);   \
-            break;                                  \
-        case WARNING:                               \
-            fprintf(stderr, "[WARNING] %s\n", msg); \
-            break;                                  \
-        case INFO:                                  \
-            fprintf(stdout, "[INFO] %s\n", msg);    \
-            break;                                  \
-        case DEBUG:                                 \
-            fprintf(stdout, "[DEBUG] %s\n", msg);   \
-            break;                                  \
-        default:                                    \
-            fprintf(stdout, "[UNKNOWN] %s\n", msg); \
-            break;                                  \
-        }                                           \
-    } while (0)
+#define NEO_LOG(level, msg) NEO_LOGF(level, "%s", msg)
 
 // check if the neo.c build C file has changed since the previous compilation of it to neo
 // (done by checking the modified date/time of neo.c; if this time comes after the last modified of neo.c, we need to rebuild neo from this new neo.c)
@@ -102,13 +211,28 @@ typedef enum
     SH    /**< Standard shell (sh) */
 } neoshell_t;
 
+#define NEOCMD_INLINE_ARGS (16)   /**< Number of arguments a command holds before its offsets move to the heap */
+#define NEOCMD_INLINE_ARENA (256) /**< Number of argument bytes a command holds before its arena moves to the heap */
+
 /**
  * Structure representing a command to be executed.
+ *
+ * The arguments are packed one after another, each NUL terminated, into a single arena owned by
+ * the command. Small commands live entirely inside the structure; larger ones move their offsets
+ * and arena to the heap, growing them geometrically. Use neocmd_arg_num and neocmd_arg to read
+ * the arguments.
  */
 typedef struct
 {
-    dyn_arr_t *args;  /**< Dynamic array storing command arguments. */
-    neoshell_t shell; /**< Shell type used to execute the command. */
+    size_t *offsets;                           /**< Heap storage for the argument offsets, or NULL while inline_offsets is used. */
+    char *arena;                               /**< Heap storage for the argument bytes, or NULL while inline_arena is used. */
+    size_t arg_num;                            /**< Number of arguments. */
+    size_t offset_capacity;                    /**< Capacity of offsets, in offsets. */
+    size_t arena_len;                          /**< Bytes used in the arena, including the NUL terminators. */
+    size_t arena_capacity;                     /**< Capacity of arena, in bytes. */
+    neoshell_t shell;                          /**< Shell type used to execute the command. */
+    size_t inline_offsets[NEOCMD_INLINE_ARGS]; /**< Offsets of the arguments of a small command. */
+    char inline_arena[NEOCMD_INLINE_ARENA];    /**< Arguments of a small command. */
 } neocmd_t;
 
 /**
@@ -124,6 +248,10 @@ typedef struct
 
 #define neo_link(compiler, executable, linker_flags, forced_linking, ...) neo_link_null((compiler), (executable), (linker_flags), (forced_linking), __VA_ARGS__, NULL)
 
+#define neo_link_shared(compiler, library, soname, linker_flags, forced_linking, ...) neo_link_shared_null((compiler), (library), (soname), (linker_flags), (forced_linking), __VA_ARGS__, NULL)
+
+#define neo_link_static(archive, thin_archive, forced_archiving, ...) neo_link_static_null((archive), (thin_archive), (forced_archiving), __VA_ARGS__, NULL)
+
 /**
  * Generates a string representation of a label, ensuring compatibility with filenames containing whitespaces.
  *
@@ -215,6 +343,23 @@ bool neoshell_wait(pid_t pid, int *status, int *code, bool should_print);
  */
 bool neocmd_append_null(neocmd_t *neocmd, ...);
 
+/**
+ * Gets the number of arguments of a command.
+ *
+ * @param neocmd Pointer to the command structure.
+ * @return The number of arguments appended to the command.
+ */
+size_t neocmd_arg_num(const neocmd_t *neocmd);
+
+/**
+ * Gets an argument of a command.
+ *
+ * @param neocmd Pointer to the command structure.
+ * @param index Index of the argument.
+ * @return The NUL terminated argument, valid until the next append to the command, or NULL if index is out of range.
+ */
+const char *neocmd_arg(const neocmd_t *neocmd, size_t index);
+
 /**
  * Generates a string representation of the command.
  *
@@ -226,6 +371,86 @@ bool neocmd_append_null(neocmd_t *neocmd, ...);
  */
 const char *neocmd_render(neocmd_t *neocmd);
 
+/**
+ * Gets the length of the string representation of the command.
+ *
+ * The length is known without rendering, so a buffer of exactly the right size can be prepared
+ * for neocmd_render_into.
+ *
+ * @param neocmd Pointer to the command structure.
+ * @return The length of the rendered command, excluding the NUL terminator.
+ */
+size_t neocmd_render_len(const neocmd_t *neocmd);
+
+/**
+ * Renders the command into a caller-provided buffer, without allocating.
+ *
+ * Like snprintf, at most size - 1 characters are written, the result is always NUL terminated
+ * (if size is not 0) and the full length is returned, so a return value of size or more means
+ * the rendered command was truncated.
+ *
+ * @param neocmd Pointer to the command structure.
+ * @param buffer The buffer to render into (can be NULL if size is 0).
+ * @param size The size of buffer, in bytes.
+ * @return The length of the complete rendered command, excluding the NUL terminator.
+ */
+size_t neocmd_render_into(const neocmd_t *neocmd, char *buffer, size_t size);
+
+/**
+ * A prepared command with slots, filled in per instantiation (see neocmd_template_create).
+ */
+typedef struct neocmd_template neocmd_template_t;
+
+/**
+ * Marks a slot among the arguments of neocmd_template_create.
+ */
+extern const char neocmd_slot[];
+#define NEOCMD_SLOT (neocmd_slot)
+
+/**
+ * Creates a command template.
+ *
+ * The fixed arguments are copied once, into the template. Each NEOCMD_SLOT argument is a slot
+ * that gets its value when the template is instantiated.
+ *
+ * @param shell The shell type to be used for executing the instantiated commands.
+ * @param ... The NULL-terminated arguments of the template, NEOCMD_SLOT marking the slots.
+ * @return Pointer to a newly allocated template, or NULL on failure.
+ */
+neocmd_template_t *neocmd_template_create_null(neoshell_t shell, ...);
+
+#define neocmd_template_create(shell, ...) neocmd_template_create_null((shell), __VA_ARGS__, NULL)
+
+/**
+ * Instantiates a command template.
+ *
+ * The command is built with a single reservation; every run of fixed arguments between two
+ * slots is copied as one block, so the cost hardly depends on the number of fixed arguments.
+ *
+ * @param cmd_template Pointer to the template.
+ * @param ... The NULL-terminated values of the slots, in order; there must be exactly one per slot.
+ * @return Pointer to a newly allocated command (free it with neocmd_delete), or NULL on failure.
+ */
+neocmd_t *neocmd_template_instantiate_null(const neocmd_template_t *cmd_template, ...);
+
+#define neocmd_template_instantiate(cmd_template, ...) neocmd_template_instantiate_null((cmd_template), __VA_ARGS__, NULL)
+
+/**
+ * Gets the number of slots of a command template.
+ *
+ * @param cmd_template Pointer to the template.
+ * @return The number of slots.
+ */
+size_t neocmd_template_slot_num(const neocmd_template_t *cmd_template);
+
+/**
+ * Deletes a command template.
+ *
+ * @param cmd_template Pointer to the template.
+ * @return true if the template was successfully deleted, false otherwise.
+ */
+bool neocmd_template_delete(neocmd_template_t *cmd_template);
+
 /**
  * Checks if the build file has changed since the previous compilation and rebuilds if necessary.
  *
@@ -253,6 +478,112 @@ bool neo_mkdir(const char *dir_path, mode_t mode);
  */
 neoconfig_t *neo_parse_config(const char *config_file_path, size_t *config_arr_len);
 
+/**
+ * A parsed configuration file; keys are looked up through a hash table.
+ */
+typedef struct neoconfig_store neoconfig_store_t;
+
+/**
+ * Loads a configuration file of 'key = value;' statements into a config store.
+ *
+ * The file is memory mapped and parsed in a single pass. Whitespace around keys and values is
+ * trimmed, while whitespace inside values is kept (see neo_config_get_list). A repeated key
+ * takes its last value.
+ *
+ * @param config_file_path Path to the configuration file.
+ * @return Pointer to the config store (free it with neo_config_free), or NULL on failure.
+ */
+neoconfig_store_t *neo_config_load(const char *config_file_path);
+
+/**
+ * Loads the configuration file given on the command line as --config=<path> (see neo_config_load).
+ *
+ * @param argv The NULL-terminated argument vector passed to main.
+ * @return Pointer to the config store, or NULL if there is no --config argument or on failure.
+ */
+neoconfig_store_t *neo_config_load_arg(char **argv);
+
+/**
+ * Frees a config store, including every string and list obtained from it.
+ *
+ * @param store The config store (can be NULL).
+ */
+void neo_config_free(neoconfig_store_t *store);
+
+/**
+ * Gets the number of distinct keys of a config store.
+ *
+ * @param store The config store.
+ * @return The number of keys.
+ */
+size_t neo_config_count(const neoconfig_store_t *store);
+
+/**
+ * Looks up the value of a key.
+ *
+ * @param store The config store.
+ * @param key The key to look up.
+ * @return The value (owned by the store), or NULL if the key is not present.
+ */
+const char *neo_config_get(const neoconfig_store_t *store, const char *key);
+
+/**
+ * Looks up a boolean value: true, yes, on or 1, and false, no, off or 0 (case insensitive).
+ *
+ * @param store The config store.
+ * @param key The key to look up.
+ * @param value Where to store the value.
+ * @return true if the key is present and its value is a boolean, false otherwise.
+ */
+bool neo_config_get_bool(const neoconfig_store_t *store, const char *key, bool *value);
+
+/**
+ * Looks up an integer value (decimal, or hexadecimal and octal with the usual C prefixes).
+ *
+ * @param store The config store.
+ * @param key The key to look up.
+ * @param value Where to store the value.
+ * @return true if the key is present and its value is an integer, false otherwise.
+ */
+bool neo_config_get_int(const neoconfig_store_t *store, const char *key, int64_t *value);
+
+/**
+ * Looks up a list value, whose items are separated by whitespace.
+ *
+ * The list is split on the first lookup of the key and kept by the store.
+ *
+ * @param store The config store.
+ * @param key The key to look up.
+ * @param count Where to store the number of items.
+ * @return The items (owned by the store), or NULL if the key is not present.
+ */
+const char **neo_config_get_list(neoconfig_store_t *store, const char *key, size_t *count);
+
+/**
+ * Enables collecting timings of neobuild's own work (stat calls, hashing, command rendering,
+ * spawning, waiting and config parsing) and counts of run and skipped build steps.
+ * The summary is printed to stderr at exit.
+ *
+ * @param json true to print the summary as a single line of JSON, false for a table.
+ */
+void neo_stats_enable(bool json);
+
+/**
+ * Enables stats (see neo_stats_enable) if argv contains --stats (a table) or --stats=json.
+ *
+ * @param argv The NULL-terminated argument vector passed to main.
+ * @return true if stats were enabled, false otherwise.
+ */
+bool neo_parse_stats_arg(char **argv);
+
+/**
+ * Prints the stats collected so far.
+ *
+ * @param stream The stream to print to.
+ * @param json true to print a single line of JSON, false for a table.
+ */
+void neo_stats_dump(FILE *stream, bool json);
+
 /**
  * Frees the memory allocated for a configuration array.
  *
@@ -297,6 +628,89 @@ bool neo_compile_to_object_file(neocompiler_t compiler, const char *source, cons
 // if the executable doesn't exist, forced_linking doesn't have any effect
 bool neo_link_null(neocompiler_t compiler, const char *executable, const char *linker_flags, bool forced_linking, ...);
 
+// links the provided object files into a shared library (-shared) in the same way neo_link_null links executables
+// the object files must have been compiled as position independent code (-fPIC in the compiler flags)
+// if soname is not NULL, it is recorded as the DT_SONAME of the library (-Wl,-soname for gcc and clang, -soname for ld)
+// the timestamp caching and forced_linking behave exactly as in neo_link_null
+bool neo_link_shared_null(neocompiler_t compiler, const char *library, const char *soname, const char *linker_flags, bool forced_linking, ...);
+
+// archives the provided object files into a static library using ar
+// the archive is updated incrementally; only the object files newer than the archive are handed to ar,
+// which replaces those members in place and leaves the rest of the archive untouched
+// if the archive doesn't exist, it is created from all the object files
+// enabling thin_archive creates a thin archive (ar T), which references the object files by path instead of copying them
+// enabling forced_archiving deletes the archive and recreates it from all the object files, which also drops
+// members that are no longer part of the object list (an incremental update never removes members)
+// note that ar identifies regular archive members by file name, so object files sharing a name
+// across directories must go into a thin archive
+bool neo_link_static_null(const char *archive, bool thin_archive, bool forced_archiving, ...);
+
+/**
+ * Opens the compiled build manifest at manifest_path.
+ *
+ * A manifest is the fully evaluated list of build steps (compilations, links and archives,
+ * with their commands and inputs) of a previous run of the build logic. It is keyed by a hash
+ * of the build file and of the other inputs the build logic depends on (config files and the like).
+ *
+ * If the manifest exists and its key matches, it is memory mapped and true is returned; the build
+ * logic can then be skipped entirely in favour of neo_manifest_replay, which goes straight to the
+ * up to date checks of the recorded steps.
+ * Otherwise false is returned and every build step executed until neo_manifest_close is recorded,
+ * so that the next run can be replayed.
+ *
+ * Only steps executed through the neo_compile and neo_link functions are recorded; commands run
+ * directly through neocmd_run_* are not part of a manifest.
+ *
+ * @param manifest_path Path of the manifest file.
+ * @param build_file Path to the build file (neo.c) whose logic is being cached.
+ * @param inputs Paths of any other files the build logic depends on (can be NULL if input_num is 0).
+ * @param input_num Number of paths in inputs.
+ * @return true if an up to date manifest was mapped and can be replayed, false otherwise.
+ */
+bool neo_manifest_open(const char *manifest_path, const char *build_file, const char **inputs, size_t input_num);
+
+/**
+ * Executes the build steps recorded in the open manifest, in the recorded order.
+ * Each step is only run if its output is out of date, exactly as it would have been by the build logic.
+ *
+ * @return true if every step succeeded, false if a step failed (the remaining steps are not run)
+ *         or no up to date manifest is open.
+ */
+bool neo_manifest_replay(void);
+
+/**
+ * Closes the open manifest.
+ * If the manifest was being recorded, the recorded steps are written to the manifest file,
+ * unless a step failed, in which case the recording doesn't capture the full build and is dropped.
+ *
+ * @return true if the manifest was closed (and written) successfully, false otherwise.
+ */
+bool neo_manifest_close(void);
+
+/**
+ * Starts emitting a ninja manifest (build.ninja) at ninja_path.
+ *
+ * Until neo_ninja_end is called, the neo_compile and neo_link functions write their commands as
+ * ninja build statements instead of executing them, so that the build can be handed to ninja
+ * while the build file stays the single source of truth.
+ * Compilations with gcc or clang additionally write a dependency file (-MMD) which ninja uses to
+ * track headers. Archives are recreated as a whole by ninja. forced flags have no effect on the
+ * emitted manifest, since ninja decides what is stale.
+ * The paths in the manifest are the ones given to neobuild, so ninja must be run from the same directory
+ * (ninja -f <ninja_path>).
+ *
+ * @param ninja_path Path of the ninja manifest to write.
+ * @return true if the emission was started, false otherwise.
+ */
+bool neo_ninja_begin(const char *ninja_path);
+
+/**
+ * Finishes emitting the ninja manifest started with neo_ninja_begin and writes it out.
+ *
+ * @return true if the manifest was written successfully, false otherwise.
+ */
+bool neo_ninja_end(void);
+
 #ifdef NEO_REMOVE_PREFIX
 
 #define cmd_create neocmd_create
@@ -14,6 +14,39 @@ typedef struct
     int64_t len;
 } position_t;
 
+/**
+ * @brief Finds the first occurrence of a pattern in a string
+ *
+ * The algorithm is picked by pattern length: memchr for single bytes, a first-and-last-byte
+ * SSE2/AVX2 filter (chosen at runtime by CPU support) for patterns up to 32 bytes, and Horspool
+ * for longer ones. Neither the string nor the pattern has to be null-terminated.
+ *
+ * @return int64_t Index of the first match (0 for an empty pattern), -1 on error, -2 if not found
+ *
+ * Errors:
+ * - Returns -1 if a pointer is NULL but its length isn't 0 (sets STRIX_ERR_NULL_PTR)
+ */
+int64_t string_search(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
+
+/**
+ * @brief Finds every occurrence of a pattern in a string (see string_search); matches may overlap
+ *
+ * @return position_t* The positions (len is -2 if there are none), or NULL on error
+ *
+ * Errors:
+ * - Returns NULL if a pointer is NULL, the pattern is empty or longer than the string (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+position_t *string_search_all(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
+
+/**
+ * @brief Counts the occurrences of a pattern in a string (see string_search); matches may overlap
+ *
+ * @return int64_t The number of matches (0 for an empty pattern), -1 on error
+ */
+int64_t string_search_all_len(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
+
+// the former KMP entry points, now forwarding to the functions above
 int64_t kmp_search(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
 position_t *kmp_search_all(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
 int64_t kmp_search_all_len(const char *pattern, const char *string, size_t pattern_len, size_t string_len);
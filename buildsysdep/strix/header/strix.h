@@ -7,27 +7,67 @@
 #include <stdio.h>
 #include "string_search.h"
 #include <stdbool.h>
+#include <stdarg.h>
+
+#define STRIX_INLINE_LEN (sizeof(char *) + 2 * sizeof(size_t) - 1) // longest string a strix_t holds without a separate allocation (23 bytes on 64-bit)
+#define STRIX_INLINE_TAG 0x80                                      // set in local.tag when the string is stored inline
 
 /**
  * @brief String handling structure that stores both the string and its length
  *
  * This structure provides a way to handle strings with explicit length tracking,
  * avoiding the need for null-termination and allowing for binary data.
+ *
+ * Strings of up to STRIX_INLINE_LEN bytes are stored in the structure itself, in local.str, and longer
+ * ones on the heap; the last byte tells them apart, being local.tag for an inline string and the last byte
+ * of heap.capacity (which never has STRIX_INLINE_TAG set) otherwise. The fields are therefore read
+ * through strix_str and strix_len rather than directly. A zero-initialized strix_t is an empty string
+ * without a buffer, like one emptied by strix_clear.
  */
 typedef struct
 {
-    char *str;  // Pointer to the string data
-    size_t len; // Length of the string
+    union
+    {
+        struct
+        {
+            char *str;       // Pointer to the string data (NULL when there is none)
+            size_t len;      // Length of the string
+            size_t capacity; // Bytes available at str, encoded so as to keep STRIX_INLINE_TAG clear
+        } heap;
+        struct
+        {
+            char str[STRIX_INLINE_LEN];
+            unsigned char tag; // STRIX_INLINE_TAG | length of the string
+        } local;
+    };
 } strix_t;
 
+/**
+ * @brief Returns the characters of a strix_t (NULL if it has no buffer)
+ *
+ * The pointer stays valid until the next modification of the strix_t. An inline string lives in the
+ * structure itself, so a copy of a strix_t made by value carries its own characters; a heap one shares
+ * the buffer of the original, as it always has.
+ */
+static inline char *strix_str(const strix_t *strix)
+{
+    return (strix->local.tag & STRIX_INLINE_TAG) ? (char *)strix->local.str : strix->heap.str;
+}
+
+/**
+ * @brief Returns the length of a strix_t
+ */
+static inline size_t strix_len(const strix_t *strix)
+{
+    return (strix->local.tag & STRIX_INLINE_TAG) ? (size_t)(strix->local.tag & ~STRIX_INLINE_TAG) : strix->heap.len;
+}
+
 typedef struct
 {
     strix_t **strix_arr;
     size_t len;
 } strix_arr_t;
 
-#define MAX_SUBSTRIX_NUM 2048
-
 /**
  * @brief Format macro for printf-style functions
  *
@@ -37,12 +77,67 @@ typedef struct
 #define STRIX_FORMAT "%.*s"
 
 /**
- * @brief Print macro for strix_t structures
+ * @brief Print macro for strix_t structures and views
  *
- * Expands to the length and string pointer needed by STRIX_FORMAT.
- * Must be used in conjunction with STRIX_FORMAT.
+ * Expands to the length and string pointer needed by STRIX_FORMAT, for a pointer to either a
+ * strix_t or a strix_view_t. Must be used in conjunction with STRIX_FORMAT.
+ */
+#define STRIX_PRINT(string) (int)STRIX_PRINT_VIEW(string).len, STRIX_PRINT_VIEW(string).str
+
+/**
+ * @brief Non-owning view of a string: a pointer and a length
+ *
+ * A view borrows the characters of a strix_t, a C-style string or a mapped file and must not
+ * outlive them. Views are passed and returned by value, never allocate and never need freeing;
+ * strix_from_view makes an owned copy when one is needed.
+ * Example: printf(STRIX_FORMAT, STRIX_PRINT(&my_view));
+ */
+typedef struct
+{
+    const char *str; // Pointer to the first character (not null-terminated)
+    size_t len;      // Length of the view
+} strix_view_t;
+
+typedef struct
+{
+    strix_view_t *view_arr;
+    size_t len;
+} strix_view_arr_t;
+
+// STRIX_PRINT takes strix_t and strix_view_t pointers alike; unlike strix_view these don't touch strix_errno
+static inline strix_view_t strix_print_strix(const strix_t *strix)
+{
+    strix_view_t view = {strix_str(strix), strix_len(strix)};
+    return view;
+}
+
+static inline strix_view_t strix_print_view(const strix_view_t *view)
+{
+    return *view;
+}
+
+#define STRIX_PRINT_VIEW(string) \
+    _Generic((string), strix_view_t *: strix_print_view, const strix_view_t *: strix_print_view, default: strix_print_strix)(string)
+
+/**
+ * @brief State of a lazy split (see strix_split_iter and strix_split_next)
  */
-#define STRIX_PRINT(string) (int)(string)->len, (string)->str
+typedef struct
+{
+    strix_view_t rest;      // Part of the view not split yet
+    strix_view_t separator; // Separator to split at; when empty, delim is used
+    char delim;
+} strix_split_iter_t;
+
+/**
+ * @brief State of a lazy search (see strix_find_iter and strix_find_next)
+ */
+typedef struct
+{
+    strix_view_t view;
+    strix_view_t needle;
+    size_t offset; // Where the next search starts
+} strix_find_iter_t;
 
 /**
  * @brief Creates a new strix_t structure from a C-style string
@@ -101,6 +196,35 @@ bool strix_modify(strix_t *strix, const char *str);
  */
 bool strix_clear(strix_t *strix);
 
+/**
+ * @brief Makes room for at least capacity bytes without changing the string
+ *
+ * Lets a string that will be built by appending grow once instead of geometrically.
+ *
+ * @param strix strix_t structure to grow
+ * @param capacity Number of bytes the string should hold without reallocating
+ * @return bool true on success, false on failure
+ *
+ * Edge cases:
+ * - Returns false if input strix is NULL
+ * - Returns false if memory allocation fails
+ * - Does nothing if the capacity is already large enough
+ */
+bool strix_reserve(strix_t *strix, size_t capacity);
+
+/**
+ * @brief Releases the unused capacity of a strix_t structure
+ *
+ * @param strix strix_t structure to shrink
+ * @return bool true on success, false on failure
+ *
+ * Edge cases:
+ * - Returns false if input strix is NULL
+ * - Returns false if memory allocation fails
+ * - The buffer of an empty string is kept
+ */
+bool strix_shrink_to_fit(strix_t *strix);
+
 /**
  * @brief Concatenates two strix_t structures, modifying the first one
  *
@@ -130,6 +254,36 @@ bool strix_concat(strix_t *strix_dest, const strix_t *strix_src);
  */
 bool strix_append(strix_t *strix, const char *str);
 
+/**
+ * @brief Appends printf-style formatted text to a strix_t structure
+ *
+ * Formats directly into the spare capacity, growing the string at most once. Literal text, %s,
+ * %.*s (STRIX_FORMAT), %% and %d, %i and %u (plain or with l, ll or z) are converted without
+ * going through vsnprintf; any other conversion formats the rest of the string with it.
+ * On success the string is followed by a null byte that is not counted in its length, so
+ * strix_str(strix) can be passed to functions expecting a C-style string until the next modification.
+ *
+ * @param strix Target strix_t structure to modify
+ * @param format printf-style format string
+ * @return bool true on success, false on failure
+ *
+ * Edge cases:
+ * - Returns false if input strix or format is NULL
+ * - Returns false if memory allocation fails
+ * - Returns false if the format can't be formatted (STRIX_ERR_STDIO)
+ */
+bool strix_appendf(strix_t *strix, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * @brief strix_appendf taking a va_list
+ *
+ * @param strix Target strix_t structure to modify
+ * @param format printf-style format string
+ * @param args Arguments of the format, consumed as by vsnprintf
+ * @return bool true on success, false on failure
+ */
+bool strix_vappendf(strix_t *strix, const char *format, va_list args);
+
 /**
  * @brief Inserts the source strix_t structure's string to the destination strix_t structure's string at position pos
  *
@@ -170,8 +324,9 @@ bool strix_insert_str(strix_t *strix, size_t pos, const char *substr);
  *
  * Edge cases:
  * - Returns false if input strix is NULL
- * - Returns false if pos is greater than string length
+ * - Returns false if pos is greater than or equal to string length
  * - If len exceeds remaining string length, truncates to end of string
+ * - Erases in place; the capacity is kept
  */
 bool strix_erase(strix_t *strix, size_t len, size_t pos);
 
@@ -262,6 +417,355 @@ int64_t strix_find_subtrix(const strix_t *strix_one, const strix_t *strix_two);
  */
 position_t *strix_find_subtrix_all(const strix_t *strix_one, const strix_t *strix_two);
 
+/**
+ * @brief A search pattern compiled once and reusable across any number of strings
+ *
+ * Compiling does the per-pattern work of strix_find (choosing the search algorithm, building the
+ * Horspool shift table of long patterns) a single time. A compiled pattern is never modified
+ * by the searches, so it can be shared between threads.
+ */
+typedef struct strix_pattern strix_pattern_t;
+
+/**
+ * @brief Compiles a C-style string into a search pattern
+ *
+ * @param substr Pattern to search for (copied; need not outlive the compiled pattern)
+ * @return strix_pattern_t* The compiled pattern (free with strix_pattern_free), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if substr is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if substr is empty (sets STRIX_ERR_EMPTY_STRING)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+strix_pattern_t *strix_pattern_compile(const char *substr);
+
+/**
+ * @brief Compiles the string of a strix_t into a search pattern (see strix_pattern_compile)
+ *
+ * @param substrix Pattern to search for (copied)
+ * @return strix_pattern_t* The compiled pattern, or NULL if there is an error
+ */
+strix_pattern_t *strix_pattern_compile_strix(const strix_t *substrix);
+
+/**
+ * @brief Frees a compiled pattern
+ *
+ * @param pattern The compiled pattern (can be NULL)
+ */
+void strix_pattern_free(strix_pattern_t *pattern);
+
+/**
+ * @brief Finds the first occurrence of a compiled pattern in a strix_t
+ *
+ * @return int64_t Index of the first match, -1 on error, -2 if not found
+ */
+int64_t strix_pattern_find(const strix_pattern_t *pattern, const strix_t *strix);
+
+/**
+ * @brief Finds the first occurrence of a compiled pattern in a view
+ *
+ * @return int64_t Index of the first match, -1 on error, -2 if not found
+ */
+int64_t strix_pattern_find_view(const strix_pattern_t *pattern, strix_view_t view);
+
+/**
+ * @brief Finds every occurrence of a compiled pattern in a strix_t; matches may overlap
+ *
+ * Unlike strix_find_all, a string shorter than the pattern simply has no matches.
+ *
+ * @return position_t* The positions (len is -2 if there are none), or NULL on error
+ */
+position_t *strix_pattern_find_all(const strix_pattern_t *pattern, const strix_t *strix);
+
+/**
+ * @brief Counts the occurrences of a compiled pattern in a strix_t; matches may overlap
+ *
+ * @return int64_t The number of matches, -1 on error
+ */
+int64_t strix_pattern_count(const strix_pattern_t *pattern, const strix_t *strix);
+
+/**
+ * @brief A set of patterns compiled into an Aho-Corasick automaton, searched for all at once
+ *
+ * The automaton is a dense transition table over byte classes (bytes that appear in no pattern
+ * share a single class), so a scan costs one table lookup per byte of text however many patterns
+ * there are. Like strix_pattern_t, it is read-only once compiled and can be shared between threads.
+ */
+typedef struct strix_multi_pattern strix_multi_pattern_t;
+
+/**
+ * @brief A match of a multi-pattern search
+ */
+typedef struct
+{
+    size_t pattern_id; // Index of the pattern in the array given to strix_multi_pattern_compile
+    size_t pos;        // Index of the first character of the match
+} strix_match_t;
+
+typedef struct
+{
+    strix_match_t *match_arr;
+    size_t len;
+    size_t capacity;
+} strix_match_arr_t;
+
+/**
+ * @brief Called for every match of strix_multi_pattern_scan
+ *
+ * @return bool true to continue the scan, false to stop it
+ */
+typedef bool (*strix_match_callback_t)(size_t pattern_id, size_t pos, void *context);
+
+/**
+ * @brief Compiles a set of patterns for multi-pattern search
+ *
+ * @param patterns Array of null-terminated patterns (copied; need not outlive the automaton)
+ * @param pattern_num Number of patterns
+ * @return strix_multi_pattern_t* The automaton (free with strix_multi_pattern_free), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if patterns or one of them is NULL, or pattern_num is 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if a pattern is empty (sets STRIX_ERR_EMPTY_STRING)
+ * - Returns NULL if the patterns are too long in total (sets STRIX_ERR_INVALID_LENGTH)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+strix_multi_pattern_t *strix_multi_pattern_compile(const char **patterns, size_t pattern_num);
+
+/**
+ * @brief Frees a compiled multi-pattern automaton
+ *
+ * @param multi The automaton (can be NULL)
+ */
+void strix_multi_pattern_free(strix_multi_pattern_t *multi);
+
+/**
+ * @brief Gets the number of patterns of a multi-pattern automaton
+ */
+size_t strix_multi_pattern_num(const strix_multi_pattern_t *multi);
+
+/**
+ * @brief Finds every occurrence of every pattern in a single pass over a view
+ *
+ * Matches are reported in order of their end position; matches ending at the same position are
+ * reported longest first. Overlapping matches are all reported.
+ *
+ * @param multi The automaton
+ * @param view View to search in
+ * @param callback Called for every match (can be NULL to only count them)
+ * @param context Passed to callback
+ * @return int64_t Number of matches reported (including the one that stopped the scan), -1 on error
+ *
+ * Errors:
+ * - Returns -1 if multi is NULL, or view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ */
+int64_t strix_multi_pattern_scan(const strix_multi_pattern_t *multi, strix_view_t view, strix_match_callback_t callback, void *context);
+
+/**
+ * @brief Collects every match of a multi-pattern search (see strix_multi_pattern_scan)
+ *
+ * @return strix_match_arr_t* The matches (free with strix_free_match_arr), or NULL if there is an error
+ */
+strix_match_arr_t *strix_multi_pattern_find_all(const strix_multi_pattern_t *multi, strix_view_t view);
+
+/**
+ * @brief Frees the matches returned by strix_multi_pattern_find_all
+ *
+ * @param match_arr The matches (can be NULL)
+ */
+void strix_free_match_arr(strix_match_arr_t *match_arr);
+
+/**
+ * @brief A set of unique strings, each stored once and identified by a dense id
+ *
+ * Interning the same characters twice returns the same id and the same pointer, so interned strings
+ * compare equal exactly when their pointers (or ids) do. Ids count up from 0 in insertion order, so
+ * they can index plain arrays of per-string data. The strings are kept null terminated in an arena
+ * and never move until the table is freed. A table is not thread-safe.
+ */
+typedef struct strix_intern strix_intern_t;
+
+/**
+ * @brief Creates an empty intern table
+ *
+ * @return strix_intern_t* The table (free with strix_intern_free), or NULL if memory allocation fails
+ */
+strix_intern_t *strix_intern_create(void);
+
+/**
+ * @brief Frees an intern table along with every string interned in it
+ *
+ * @param table The table (can be NULL)
+ */
+void strix_intern_free(strix_intern_t *table);
+
+/**
+ * @brief Gets the id of a string, interning it if it isn't in the table yet
+ *
+ * @param table The table
+ * @param view The characters to intern (copied)
+ * @return int64_t The id, -1 on error
+ *
+ * Errors:
+ * - Returns -1 if table is NULL, or view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns -1 if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+int64_t strix_intern_id(strix_intern_t *table, strix_view_t view);
+
+/**
+ * @brief Interns a string, returning its stable copy
+ *
+ * @param table The table
+ * @param view The characters to intern (copied)
+ * @return const char* The null-terminated interned copy, valid until the table is freed; NULL on error
+ */
+const char *strix_intern(strix_intern_t *table, strix_view_t view);
+
+/**
+ * @brief strix_intern for a C-style string
+ */
+const char *strix_intern_cstr(strix_intern_t *table, const char *str);
+
+/**
+ * @brief Gets the id of a string without interning it
+ *
+ * @param table The table
+ * @param view The characters to look up
+ * @return int64_t The id, -2 if the string isn't interned, -1 on error
+ */
+int64_t strix_intern_find(const strix_intern_t *table, strix_view_t view);
+
+/**
+ * @brief Gets the string of an id
+ *
+ * @param table The table
+ * @param id An id returned by strix_intern_id
+ * @return strix_view_t The interned string (null terminated past its length), or {NULL, 0} if id is out of range
+ */
+strix_view_t strix_intern_get(const strix_intern_t *table, size_t id);
+
+/**
+ * @brief Gets the number of strings in an intern table
+ */
+size_t strix_intern_count(const strix_intern_t *table);
+
+/**
+ * @brief A 128-bit hash; low is the 64-bit hash of the same input
+ */
+typedef struct
+{
+    uint64_t low;
+    uint64_t high;
+} strix_hash128_t;
+
+#define STRIX_HASH_SECRET_LEN 192
+#define STRIX_HASH_BUFFER_LEN 256
+
+/**
+ * @brief The state of a hash computed over input arriving in pieces
+ *
+ * Lives wherever the caller puts it (usually the stack) and owns no memory. Its members are private.
+ */
+typedef struct
+{
+    uint64_t acc[8];
+    uint8_t secret[STRIX_HASH_SECRET_LEN];
+    uint8_t buffer[STRIX_HASH_BUFFER_LEN];
+    size_t buffered;
+    size_t block_stripe;
+    uint64_t total_len;
+    uint64_t seed;
+} strix_hash_state_t;
+
+/**
+ * @brief Hashes a buffer with a fast non-cryptographic 64-bit hash
+ *
+ * Short inputs take a few multiplications; long ones run through 8 lanes of 64-bit accumulators,
+ * vectorized with SSE2, AVX2 or AVX-512 depending on the CPU. Every path gives the same hash, on every
+ * machine. Different seeds give unrelated hashes. The hash is not meant to resist deliberate collisions.
+ *
+ * @param data The bytes to hash (can be NULL if len is 0)
+ * @param len Number of bytes
+ * @param seed Seed of the hash (0 is fine)
+ * @return uint64_t The hash, 0 if data is NULL but len isn't (sets STRIX_ERR_NULL_PTR)
+ */
+uint64_t strix_hash64(const void *data, size_t len, uint64_t seed);
+
+/**
+ * @brief strix_hash64 with a 128-bit result, for fingerprints that must practically never collide
+ */
+strix_hash128_t strix_hash128(const void *data, size_t len, uint64_t seed);
+
+/**
+ * @brief Hashes the contents of a strix_t with strix_hash64
+ *
+ * @return uint64_t The hash, 0 if strix is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+uint64_t strix_hash(const strix_t *strix, uint64_t seed);
+
+/**
+ * @brief Hashes the characters of a view with strix_hash64
+ */
+uint64_t strix_view_hash(strix_view_t view, uint64_t seed);
+
+/**
+ * @brief Starts a hash over input given in pieces
+ *
+ * Feeding the pieces to strix_hash_update and then taking a digest gives the same hash as strix_hash64
+ * (or strix_hash128) over the whole input, however it was split.
+ *
+ * @param state The state to initialize
+ * @param seed Seed of the hash
+ * @return bool true on success, false if state is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+bool strix_hash_init(strix_hash_state_t *state, uint64_t seed);
+
+/**
+ * @brief Adds the next piece of input to a hash
+ *
+ * @param state A state set up by strix_hash_init
+ * @param data The bytes to add (can be NULL if len is 0)
+ * @param len Number of bytes
+ * @return bool true on success, false if state is NULL or data is NULL but len isn't (sets STRIX_ERR_NULL_PTR)
+ */
+bool strix_hash_update(strix_hash_state_t *state, const void *data, size_t len);
+
+/**
+ * @brief Gets the 64-bit hash of the input added so far; the state can keep taking input afterwards
+ */
+uint64_t strix_hash_digest64(const strix_hash_state_t *state);
+
+/**
+ * @brief Gets the 128-bit hash of the input added so far; the state can keep taking input afterwards
+ */
+strix_hash128_t strix_hash_digest128(const strix_hash_state_t *state);
+
+/**
+ * @brief Hashes the contents of a file with strix_hash64, reading it in pieces
+ *
+ * @param file_path Path of the file
+ * @param seed Seed of the hash
+ * @param hash Where to store the hash
+ * @return bool true on success, false on error
+ *
+ * Errors:
+ * - Returns false if file_path or hash is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns false if the file can't be opened or read (sets STRIX_ERR_STDIO; see errno)
+ */
+bool strix_hash_file(const char *file_path, uint64_t seed, uint64_t *hash);
+
+/**
+ * @brief Computes the CRC32C (Castagnoli) checksum of a buffer
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU has it and a lookup table otherwise. Checksums chain:
+ * passing the checksum of one buffer as crc for the next gives the checksum of both together.
+ *
+ * @param crc 0, or the checksum of the preceding data
+ * @param data The bytes to checksum (can be NULL if len is 0)
+ * @param len Number of bytes
+ * @return uint32_t The checksum, crc unchanged if data is NULL but len isn't (sets STRIX_ERR_NULL_PTR)
+ */
+uint32_t strix_crc32c(uint32_t crc, const void *data, size_t len);
+
 /**
  * @brief Splits a strix_t into array of strix_t structures by delimiter
  *
@@ -272,7 +776,7 @@ position_t *strix_find_subtrix_all(const strix_t *strix_one, const strix_t *stri
  * Edge cases:
  * - Returns NULL if input strix is NULL
  * - Returns NULL if memory allocation fails
- * - Limited to MAX_SUBSTRIX_NUM (2048) splits
+ * - Empty pieces are skipped; see strix_split_iter to split without materializing every piece
  */
 strix_arr_t *strix_split_by_delim(const strix_t *strix, const char delim);
 
@@ -293,7 +797,6 @@ void strix_free_strix_arr(strix_arr_t *strix_arr);
  * Edge cases:
  * - Returns NULL if either input is NULL
  * - Returns NULL if memory allocation fails
- * - Limited to MAX_SUBSTRIX_NUM (2048) splits
  */
 strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr);
 
@@ -307,7 +810,6 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr);
  * Edge cases:
  * - Returns NULL if either input is NULL
  * - Returns NULL if memory allocation fails
- * - Limited to MAX_SUBSTRIX_NUM (2048) splits
  */
 strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substrix);
 
@@ -390,7 +892,7 @@ void strix_free(strix_t *string);
  *
  * Edge cases:
  * - Returns false if input strix is NULL (sets STRIX_ERR_NULL_PTR)
- * - Returns false if strix->str is NULL (sets STRIX_ERR_STRIX_STR_NULL)
+ * - Returns false if strix_str(strix) is NULL (sets STRIX_ERR_STRIX_STR_NULL)
  * - Does nothing if the strix is already empty
  * - Frees the original string if it contains only whitespace
  * - Returns false if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
@@ -410,7 +912,7 @@ bool strix_trim_whitespace(strix_t *strix);
  *
  * Edge cases:
  * - Returns false if input strix is NULL (sets STRIX_ERR_NULL_PTR)
- * - Returns false if strix->str is NULL (sets STRIX_ERR_STRIX_STR_NULL)
+ * - Returns false if strix_str(strix) is NULL (sets STRIX_ERR_STRIX_STR_NULL)
  * - Does nothing if the strix is already empty
  * - Frees the original string if it contains only the trim character
  * - Returns false if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
@@ -421,54 +923,101 @@ bool strix_trim_char(strix_t *strix, const char trim);
 /**
  * @brief Converts a strix_t to a double value
  *
- * This function converts the string in the provided strix_t structure to a double value.
- * The function handles optional signs ('+' and '-') and a decimal point for fractional numbers.
- * It stores the result in a double and returns it.
+ * The whole string must be a number as strix_view_to_double reads it: an optional sign, digits with an
+ * optional decimal point and an optional exponent, or inf, infinity or nan. The result is correctly rounded.
  *
  * @param strix Pointer to the strix_t structure to convert
  * @return double The converted double value, or -1 if there is an error (error detected through strix_errno)
  *
  * Errors:
- * - Sets strix_errno to STRIX_ERR_INVALID_DOUBLE if the string is not a valid number
- * - Returns -1 if an invalid character, multiple decimal points, or improper sign usage is detected
- * - strix_errno must be checked for detailed error information
+ * - Returns -1 if strix is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns -1 if the string is empty, isn't a number or has anything after it (sets STRIX_ERR_INVALID_DOUBLE)
  */
 double strix_to_double(strix_t *strix);
 
 /**
  * @brief Converts a strix_t to a signed integer
  *
- * This function converts the string in the provided strix_t structure to a signed 64-bit integer.
- * The function handles optional signs ('+' and '-') and performs overflow checks before conversion.
- * It returns the converted integer if successful or 0 in case of failure.
+ * The whole string must be decimal digits with an optional '+' or '-' sign.
  *
  * @param strix Pointer to the strix_t structure to convert
  * @return int64_t The converted signed integer, or 0 if there is an error (error detected through strix_errno)
  *
  * Errors:
- * - Sets strix_errno to STRIX_ERR_INVALID_DOUBLE if the string is not a valid signed integer
- * - Returns 0 if the string contains invalid characters, or the integer overflows
- * - strix_errno must be checked for detailed error information
+ * - Returns 0 if strix is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns 0 if the string is empty, has no digits or has anything after them (sets STRIX_ERR_INVALID_INT)
+ * - Returns 0 if the integer doesn't fit an int64_t (sets STRIX_ERR_INT_OVERFLOW)
  */
 int64_t strix_to_signed_int(strix_t *strix);
 
 /**
  * @brief Converts a strix_t to an unsigned integer
  *
- * This function converts the string in the provided strix_t structure to an unsigned 64-bit integer.
- * It handles an optional positive sign ('+'), and performs overflow checks before conversion.
- * It returns the converted integer if successful or 0 in case of failure.
+ * The whole string must be decimal digits with an optional '+' sign.
  *
  * @param strix Pointer to the strix_t structure to convert
  * @return uint64_t The converted unsigned integer, or 0 if there is an error (error detected through strix_errno)
  *
  * Errors:
- * - Sets strix_errno to STRIX_ERR_INVALID_DOUBLE if the string is not a valid unsigned integer
- * - Returns 0 if the string contains invalid characters, or the integer overflows
- * - strix_errno must be checked for detailed error information
+ * - Returns 0 if strix is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns 0 if the string is empty, has no digits or has anything after them (sets STRIX_ERR_INVALID_INT)
+ * - Returns 0 if the integer doesn't fit a uint64_t (sets STRIX_ERR_INT_OVERFLOW)
  */
 uint64_t strix_to_unsigned_int(strix_t *strix);
 
+/**
+ * @brief Parses the number at the start of a view as a double
+ *
+ * Reads an optional sign followed by digits with an optional '.' and an optional exponent ('e' or 'E', an
+ * optional sign and digits), or by inf, infinity or nan in any case. No whitespace is skipped. The result
+ * is the double nearest the decimal value (ties to even), as strtod gives it in the C locale; values too
+ * large for a double become infinity and values too small become zero. Eight digits are taken at a time,
+ * and the binary value comes from the Eisel-Lemire algorithm, which falls back on strtod only for the rare
+ * decimal of more than 19 significant digits that it can't settle.
+ *
+ * @param view The characters to parse; what follows the number is left alone
+ * @param value Where to store the number
+ * @return size_t The number of characters that made up the number, 0 on error
+ *
+ * Errors:
+ * - Returns 0 if value is NULL, or view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns 0 if the view doesn't start with a number (sets STRIX_ERR_INVALID_DOUBLE)
+ * - Returns 0 if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+size_t strix_view_to_double(strix_view_t view, double *value);
+
+/**
+ * @brief Parses the decimal integer at the start of a view
+ *
+ * Reads an optional '+' or '-' sign and the digits after it, eight at a time. No whitespace is skipped.
+ *
+ * @param view The characters to parse; what follows the digits is left alone
+ * @param value Where to store the integer
+ * @return size_t The number of characters that made up the integer, 0 on error
+ *
+ * Errors:
+ * - Returns 0 if value is NULL, or view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns 0 if the view doesn't start with an integer (sets STRIX_ERR_INVALID_INT)
+ * - Returns 0 if the integer doesn't fit an int64_t (sets STRIX_ERR_INT_OVERFLOW)
+ */
+size_t strix_view_to_signed_int(strix_view_t view, int64_t *value);
+
+/**
+ * @brief Parses the decimal integer at the start of a view
+ *
+ * Reads an optional '+' sign and the digits after it, eight at a time. No whitespace is skipped.
+ *
+ * @param view The characters to parse; what follows the digits is left alone
+ * @param value Where to store the integer
+ * @return size_t The number of characters that made up the integer, 0 on error
+ *
+ * Errors:
+ * - Returns 0 if value is NULL, or view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns 0 if the view doesn't start with an integer (sets STRIX_ERR_INVALID_INT)
+ * - Returns 0 if the integer doesn't fit a uint64_t (sets STRIX_ERR_INT_OVERFLOW)
+ */
+size_t strix_view_to_unsigned_int(strix_view_t view, uint64_t *value);
+
 /**
  * @brief Counts the occurrences of a specific character in a strix_t
  *
@@ -532,7 +1081,7 @@ int64_t strix_count_substrix(const strix_t *strix, const strix_t *substrix);
  *
  * Errors:
  * - Returns NULL if strix is NULL (sets STRIX_ERR_NULL_PTR)
- * - Returns NULL if start > end or end >= strix->len (sets STRIX_ERR_INVALID_BOUNDS)
+ * - Returns NULL if start > end or end >= strix_len(strix) (sets STRIX_ERR_INVALID_BOUNDS)
  * - Returns NULL if stride is 0 (sets STRIX_ERR_INVALID_STRIDE)
  * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
  * - Returns NULL if memory copy fails (sets STRIX_ERR_MEMCPY_FAILED)
@@ -553,12 +1102,240 @@ void strix_free_char_arr(char_arr_t *char_arr);
 
 position_t *strix_find_all_char(const strix_t *strix, const char chr);
 
+/**
+ * @brief Loads the contents of a file into a new strix_t structure
+ *
+ * @param file_path Path of the file to load
+ * @return strix_t* Pointer to the new strix_t structure (owned by the caller), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if file_path is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if the file can't be opened or read (sets STRIX_ERR_STDIO)
+ * - Returns NULL if the file is empty (sets STRIX_ERR_EMPTY_STRING)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
 strix_t *conv_file_to_strix(const char *file_path);
 
+/**
+ * @brief Loads a file as a read-only strix_t without copying it
+ *
+ * Regular files of 16 KiB or more are memory mapped (and advised for sequential access); smaller
+ * files, pipes and other special files are read in a single pass into a buffer of the right size.
+ * The contents are not null-terminated and must not be modified.
+ *
+ * @param file_path Path of the file to load
+ * @return const strix_t* The file contents, to be released with strix_unmap_file (never strix_free), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if file_path is NULL (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if the file can't be opened or read (sets STRIX_ERR_STDIO; see errno)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+const strix_t *strix_map_file(const char *file_path);
+
+/**
+ * @brief Releases a file loaded with strix_map_file
+ *
+ * @param file The strix_t returned by strix_map_file (can be NULL)
+ */
+void strix_unmap_file(const strix_t *file);
+
 char *strix_to_cstr(strix_t *strix); // cleanup of the string is up to the user; can be freed using free(str)
 
 void strix_free_position(position_t *pos);
 
 strix_t *strix_create_empty(); // can't create empty with strix_create; but can with this
 
+/**
+ * @brief Creates a view of the whole string of a strix_t structure
+ *
+ * @param strix Source strix_t structure
+ * @return strix_view_t View of the string, or an empty view with a NULL str if strix is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+strix_view_t strix_view(const strix_t *strix);
+
+/**
+ * @brief Creates a view of a C-style string (without its null terminator)
+ *
+ * @param str Null-terminated string
+ * @return strix_view_t View of the string, or an empty view with a NULL str if str is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+strix_view_t strix_view_from_cstr(const char *str);
+
+/**
+ * @brief Copies the characters of a view into a new, owned strix_t structure
+ *
+ * @param view Source view
+ * @return strix_t* New strix_t structure (an empty one for an empty view), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+strix_t *strix_from_view(strix_view_t view);
+
+/**
+ * @brief Creates a view of the characters from start up to (but excluding) end of another view
+ *
+ * @param view Source view
+ * @param start Starting index (inclusive)
+ * @param end Ending index (exclusive); start == end gives an empty view
+ * @return strix_view_t The slice, or an empty view with a NULL str if start > end or end > view.len (sets STRIX_ERR_INVALID_BOUNDS)
+ */
+strix_view_t strix_view_slice(strix_view_t view, size_t start, size_t end);
+
+/**
+ * @brief Narrows a view to exclude whitespace at both of its ends
+ *
+ * @param view Source view
+ * @return strix_view_t The trimmed view (empty if view is all whitespace)
+ */
+strix_view_t strix_view_trim_whitespace(strix_view_t view);
+
+/**
+ * @brief Narrows a view to exclude a character repeated at both of its ends
+ *
+ * @param view Source view
+ * @param trim Character to trim
+ * @return strix_view_t The trimmed view
+ */
+strix_view_t strix_view_trim_char(strix_view_t view, const char trim);
+
+/**
+ * @brief Compares the characters of two views
+ *
+ * @return bool true if both views have the same length and characters, false otherwise
+ */
+bool strix_view_equal(strix_view_t view_one, strix_view_t view_two);
+
+/**
+ * @brief Finds the first occurrence of a character in a view
+ *
+ * @param view View to search in
+ * @param chr Character to search for
+ * @return int64_t Index of the first match, -2 if not found
+ */
+int64_t strix_view_find_char(strix_view_t view, const char chr);
+
+/**
+ * @brief Finds the first occurrence of one view in another
+ *
+ * @param view View to search in
+ * @param needle View to search for (an empty needle matches at index 0)
+ * @return int64_t Index of the first match, -1 on error, -2 if not found
+ *
+ * Errors:
+ * - Returns -1 if either view has a NULL str but a length other than 0 (sets STRIX_ERR_NULL_PTR)
+ */
+int64_t strix_view_find(strix_view_t view, strix_view_t needle);
+
+/**
+ * @brief Cuts a view around the first occurrence of a delimiter
+ *
+ * For example, cutting "key = value" at '=' gives "key " and " value".
+ *
+ * @param view View to cut
+ * @param delim Delimiter to cut at
+ * @param before Set to the part before the delimiter (the whole view if it isn't found)
+ * @param after Set to the part after the delimiter (empty if it isn't found)
+ * @return bool true if the delimiter was found, false otherwise
+ *
+ * Errors:
+ * - Returns false if before or after is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+bool strix_view_cut(strix_view_t view, const char delim, strix_view_t *before, strix_view_t *after);
+
+/**
+ * @brief Splits a view by a delimiter into an array of views
+ *
+ * Like strix_split_by_delim, empty pieces are skipped, but the pieces point into the source view
+ * and the whole result takes a single allocation, with no limit on the number of pieces.
+ *
+ * @param view View to split
+ * @param delim Delimiter character
+ * @return strix_view_arr_t* Array of views (free with strix_free_view_arr), or NULL if there is an error
+ *
+ * Errors:
+ * - Returns NULL if view.str is NULL but view.len isn't 0 (sets STRIX_ERR_NULL_PTR)
+ * - Returns NULL if memory allocation fails (sets STRIX_ERR_MALLOC_FAILED)
+ */
+strix_view_arr_t *strix_view_split_by_delim(strix_view_t view, const char delim);
+
+/**
+ * @brief Frees an array returned by strix_view_split_by_delim (the viewed characters are untouched)
+ *
+ * @param view_arr Array to free (can be NULL)
+ */
+void strix_free_view_arr(strix_view_arr_t *view_arr);
+
+/**
+ * @brief Starts a lazy split of a view by a delimiter character
+ *
+ * The pieces are produced one at a time by strix_split_next, using O(1) memory and with no limit
+ * on their number.
+ * Example:
+ * @code
+ * strix_view_t token;
+ * strix_split_iter_t iter = strix_split_iter(strix_view(line), ' ');
+ * while (strix_split_next(&iter, &token))
+ * {
+ *     printf(STRIX_FORMAT "\n", STRIX_PRINT(&token));
+ * }
+ * @endcode
+ *
+ * @param view View to split (must outlive the iterator)
+ * @param delim Delimiter character
+ * @return strix_split_iter_t The iterator
+ */
+strix_split_iter_t strix_split_iter(strix_view_t view, const char delim);
+
+/**
+ * @brief Starts a lazy split of a view by a separator string (see strix_split_iter)
+ *
+ * @param view View to split (must outlive the iterator)
+ * @param separator Separator to split at (must outlive the iterator; an empty one splits by '\0')
+ * @return strix_split_iter_t The iterator
+ */
+strix_split_iter_t strix_split_iter_substr(strix_view_t view, strix_view_t separator);
+
+/**
+ * @brief Gets the next piece of a lazy split
+ *
+ * Like strix_split_by_delim, empty pieces (between adjacent separators or at either end) are skipped.
+ *
+ * @param iter The iterator
+ * @param token Set to a view of the next piece
+ * @return bool true if a piece was produced, false once the view is exhausted
+ *
+ * Errors:
+ * - Returns false if iter or token is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+bool strix_split_next(strix_split_iter_t *iter, strix_view_t *token);
+
+/**
+ * @brief Starts a lazy search for every occurrence of a needle in a view
+ *
+ * The matches are produced one at a time by strix_find_next, using O(1) memory and with no limit
+ * on their number.
+ *
+ * @param view View to search in (must outlive the iterator)
+ * @param needle View to search for (must outlive the iterator; an empty needle never matches)
+ * @return strix_find_iter_t The iterator
+ */
+strix_find_iter_t strix_find_iter(strix_view_t view, strix_view_t needle);
+
+/**
+ * @brief Gets the position of the next match of a lazy search
+ *
+ * Like strix_find_all, matches may overlap ("aa" is found at 0, 1 and 2 in "aaaa").
+ *
+ * @param iter The iterator
+ * @param pos Set to the index of the next match
+ * @return bool true if a match was found, false once the view is exhausted
+ *
+ * Errors:
+ * - Returns false if iter or pos is NULL (sets STRIX_ERR_NULL_PTR)
+ */
+bool strix_find_next(strix_find_iter_t *iter, size_t *pos);
+
 #endif /* A4921AE8_DB77_42E3_A83E_9D3D0C69BDE0 */
\ No newline at end of file
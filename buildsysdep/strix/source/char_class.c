@@ -0,0 +1,183 @@
+#include "../header/strix.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CHAR_CLASS_X86
+#endif
+
+#include <stdatomic.h>
+
+// whitespace as isspace classifies it in the C locale, without the locale lookup per byte
+static const bool char_is_space[256] = {
+    [' '] = true,
+    ['\t'] = true,
+    ['\n'] = true,
+    ['\v'] = true,
+    ['\f'] = true,
+    ['\r'] = true,
+};
+
+typedef struct
+{
+    size_t (*count)(const char *str, size_t len, char chr);
+    size_t (*find_all)(const char *str, size_t from, size_t len, char chr, size_t *pos_arr); // pos_arr must fit every match after from
+} char_kernels_t;
+
+static size_t count_scalar(const char *str, size_t len, char chr)
+{
+    size_t count = 0;
+    for (size_t index = 0; index < len; index++)
+    {
+        count += str[index] == chr;
+    }
+    return count;
+}
+
+static size_t find_all_scalar(const char *str, size_t from, size_t len, char chr, size_t *pos_arr)
+{
+    size_t count = 0;
+    for (size_t index = from; index < len; index++)
+    {
+        if (str[index] == chr)
+        {
+            pos_arr[count++] = index;
+        }
+    }
+    return count;
+}
+
+#ifdef CHAR_CLASS_X86
+
+// every kernel compares a whole vector against the broadcast character, turns the result into a bit
+// mask and then either counts its bits or walks them; the tail shorter than a vector is left to the scalar kernels
+
+static size_t count_sse2(const char *str, size_t len, char chr)
+{
+    const __m128i needle = _mm_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = 0;
+    for (; index + 16 <= len; index += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(str + index));
+        count += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle)));
+    }
+    return count + count_scalar(str + index, len - index, chr);
+}
+
+static size_t find_all_sse2(const char *str, size_t from, size_t len, char chr, size_t *pos_arr)
+{
+    const __m128i needle = _mm_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = from;
+    for (; index + 16 <= len; index += 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i *)(str + index));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        while (mask)
+        {
+            pos_arr[count++] = index + (size_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    return count + find_all_scalar(str, index, len, chr, pos_arr + count);
+}
+
+__attribute__((target("avx2,popcnt"))) static size_t count_avx2(const char *str, size_t len, char chr)
+{
+    const __m256i needle = _mm256_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = 0;
+    for (; index + 32 <= len; index += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(str + index));
+        count += (size_t)__builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle)));
+    }
+    return count + count_sse2(str + index, len - index, chr);
+}
+
+__attribute__((target("avx2,bmi"))) static size_t find_all_avx2(const char *str, size_t from, size_t len, char chr, size_t *pos_arr)
+{
+    const __m256i needle = _mm256_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = from;
+    for (; index + 32 <= len; index += 32)
+    {
+        __m256i block = _mm256_loadu_si256((const __m256i *)(str + index));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, needle));
+        while (mask)
+        {
+            pos_arr[count++] = index + (size_t)__builtin_ctz(mask);
+            mask &= mask - 1;
+        }
+    }
+    return count + find_all_sse2(str, index, len, chr, pos_arr + count);
+}
+
+__attribute__((target("avx512bw,popcnt"))) static size_t count_avx512(const char *str, size_t len, char chr)
+{
+    const __m512i needle = _mm512_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = 0;
+    for (; index + 64 <= len; index += 64)
+    {
+        __m512i block = _mm512_loadu_si512((const void *)(str + index));
+        count += (size_t)__builtin_popcountll(_mm512_cmpeq_epi8_mask(block, needle));
+    }
+    return count + count_avx2(str + index, len - index, chr);
+}
+
+__attribute__((target("avx512bw,bmi"))) static size_t find_all_avx512(const char *str, size_t from, size_t len, char chr, size_t *pos_arr)
+{
+    const __m512i needle = _mm512_set1_epi8(chr);
+    size_t count = 0;
+    size_t index = from;
+    for (; index + 64 <= len; index += 64)
+    {
+        __m512i block = _mm512_loadu_si512((const void *)(str + index));
+        unsigned long long mask = _mm512_cmpeq_epi8_mask(block, needle);
+        while (mask)
+        {
+            pos_arr[count++] = index + (size_t)__builtin_ctzll(mask);
+            mask &= mask - 1;
+        }
+    }
+    return count + find_all_avx2(str, index, len, chr, pos_arr + count);
+}
+
+static const char_kernels_t kernels_sse2 = {count_sse2, find_all_sse2};
+static const char_kernels_t kernels_avx2 = {count_avx2, find_all_avx2};
+static const char_kernels_t kernels_avx512 = {count_avx512, find_all_avx512};
+
+// picks the widest kernels the CPU supports, probing it only once
+static const char_kernels_t *char_kernels(void)
+{
+    static _Atomic(const char_kernels_t *) selected = NULL;
+
+    const char_kernels_t *kernels = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (!kernels)
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw"))
+        {
+            kernels = &kernels_avx512;
+        }
+        else
+        {
+            kernels = __builtin_cpu_supports("avx2") ? &kernels_avx2 : &kernels_sse2;
+        }
+        atomic_store_explicit(&selected, kernels, memory_order_relaxed); // racing first calls store the same value
+    }
+
+    return kernels;
+}
+
+#else
+
+static const char_kernels_t kernels_scalar = {count_scalar, find_all_scalar};
+
+static const char_kernels_t *char_kernels(void)
+{
+    return &kernels_scalar;
+}
+
+#endif
@@ -0,0 +1,846 @@
+#include "../header/strix.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdatomic.h>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define HASH_X86
+#endif
+
+#define HASH_STRIPE_LEN 64
+#define HASH_SECRET_LEN STRIX_HASH_SECRET_LEN
+#define HASH_BUFFER_LEN STRIX_HASH_BUFFER_LEN
+#define HASH_STRIPES_PER_BLOCK ((HASH_SECRET_LEN - HASH_STRIPE_LEN) / 8) // each stripe of a block shifts the secret by 8 bytes
+#define HASH_SHORT_MAX 240
+#define HASH_SCRAMBLE_OFFSET (HASH_SECRET_LEN - HASH_STRIPE_LEN)
+#define HASH_LAST_STRIPE_OFFSET (HASH_SECRET_LEN - HASH_STRIPE_LEN - 7)
+#define HASH_HIGH_OFFSET 56 // where the secret of the upper half of a short 128-bit hash starts
+
+#define HASH_PRIME32_1 0x9E3779B1U
+#define HASH_PRIME32_2 0x85EBCA77U
+#define HASH_PRIME32_3 0xC2B2AE3DU
+#define HASH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define HASH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define HASH_PRIME64_3 0x165667B19E3779F9ULL
+#define HASH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define HASH_PRIME64_5 0x27D4EB2F165667C5ULL
+
+// key material, the output of splitmix64; unseeded hashes read it as is, seeded ones derive their own from it
+static const uint8_t hash_secret[HASH_SECRET_LEN] = {
+    0x21, 0xa2, 0xbe, 0x4a, 0x9f, 0xf6, 0xb0, 0x2c, 0x89, 0x89, 0x14, 0x23, 0x47, 0x03, 0x17, 0x94,
+    0x03, 0xfe, 0x9d, 0x60, 0x50, 0x59, 0x55, 0xdd, 0x00, 0x28, 0xb1, 0xde, 0x50, 0xb1, 0xaf, 0xdb,
+    0xb6, 0x2c, 0x44, 0x6c, 0x2e, 0x9b, 0x78, 0x7e, 0xc4, 0xf8, 0xe4, 0xc7, 0x36, 0x56, 0x1e, 0xf4,
+    0xe4, 0xa7, 0xfb, 0xf8, 0x50, 0xd1, 0x59, 0x09, 0xea, 0x9e, 0xdb, 0x3c, 0xf1, 0x16, 0x73, 0xa9,
+    0x68, 0x00, 0x52, 0xf9, 0x58, 0x82, 0xcd, 0x74, 0x8b, 0x86, 0x16, 0xe1, 0x62, 0x4a, 0xc7, 0x55,
+    0xbd, 0x3c, 0x02, 0xa2, 0x99, 0xc7, 0xf4, 0xd2, 0xb9, 0x51, 0x7b, 0xa3, 0x79, 0xcb, 0x98, 0xdf,
+    0x05, 0x39, 0x4f, 0x52, 0x85, 0x58, 0x6f, 0x39, 0x76, 0xb2, 0xa3, 0x6c, 0x38, 0x56, 0x1d, 0xaf,
+    0x5a, 0xe8, 0x04, 0x51, 0x6b, 0xbe, 0xff, 0xa9, 0xb3, 0x33, 0xd5, 0x9f, 0x1b, 0xc5, 0xd0, 0x6b,
+    0x56, 0x4b, 0xab, 0x50, 0x1c, 0xe9, 0x0c, 0x98, 0xc5, 0x62, 0xfe, 0x80, 0x57, 0x39, 0xac, 0x28,
+    0xc7, 0xed, 0xbc, 0xa6, 0xe3, 0x12, 0x89, 0x76, 0x88, 0x7c, 0x2c, 0x33, 0xc9, 0xe8, 0xb3, 0x50,
+    0xda, 0x47, 0xbd, 0x20, 0xe5, 0xbf, 0x3b, 0xce, 0x4f, 0x7c, 0xbb, 0xe0, 0xe8, 0xc8, 0xa6, 0xcb,
+    0x6d, 0x34, 0x4a, 0x43, 0xb8, 0x4d, 0x19, 0xbf, 0x7f, 0x6d, 0x41, 0x60, 0x7b, 0x2a, 0x8f, 0x7d,
+};
+
+// the hash reads little-endian words, so it comes out the same on every machine
+static inline uint32_t hash_read32(const uint8_t *ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap32(value);
+#endif
+    return value;
+}
+
+static inline uint64_t hash_read64(const uint8_t *ptr)
+{
+    uint64_t value;
+    memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+static inline void hash_write64(uint8_t *ptr, uint64_t value)
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    memcpy(ptr, &value, sizeof(value));
+}
+
+// the full 128-bit product folded to 64 bits
+static inline uint64_t hash_mul_fold(uint64_t lhs, uint64_t rhs)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)lhs * rhs;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t lo_lo = (lhs & 0xffffffff) * (rhs & 0xffffffff);
+    uint64_t hi_lo = (lhs >> 32) * (rhs & 0xffffffff);
+    uint64_t lo_hi = (lhs & 0xffffffff) * (rhs >> 32);
+    uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    uint64_t lower = (cross << 32) | (lo_lo & 0xffffffff);
+    return lower ^ upper;
+#endif
+}
+
+static inline uint64_t hash_avalanche(uint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= 0x165667919E3779F9ULL;
+    return hash ^ (hash >> 32);
+}
+
+// a stronger finish for inputs whose words went through no multiplication yet
+static inline uint64_t hash_avalanche_strong(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= HASH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= HASH_PRIME64_3;
+    return hash ^ (hash >> 32);
+}
+
+static inline uint64_t hash_rrmxmx(uint64_t hash, size_t len)
+{
+    hash ^= ((hash << 49) | (hash >> 15)) ^ ((hash << 24) | (hash >> 40));
+    hash *= 0x9FB21C651E98DF25ULL;
+    hash ^= (hash >> 35) + len;
+    hash *= 0x9FB21C651E98DF25ULL;
+    return hash ^ (hash >> 28);
+}
+
+static uint64_t hash_len_0to16(const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed)
+{
+    if (len > 8)
+    {
+        uint64_t low = hash_read64(input) ^ ((hash_read64(secret + 24) ^ hash_read64(secret + 32)) + seed);
+        uint64_t high = hash_read64(input + len - 8) ^ ((hash_read64(secret + 40) ^ hash_read64(secret + 48)) - seed);
+        return hash_avalanche(len + __builtin_bswap64(low) + high + hash_mul_fold(low, high));
+    }
+
+    if (len >= 4)
+    {
+        seed ^= (uint64_t)__builtin_bswap32((uint32_t)seed) << 32;
+        uint64_t words = hash_read32(input + len - 4) + ((uint64_t)hash_read32(input) << 32);
+        return hash_rrmxmx(words ^ ((hash_read64(secret + 8) ^ hash_read64(secret + 16)) - seed), len);
+    }
+
+    if (len)
+    {
+        // the first, middle and last bytes cover every byte of 1 to 3
+        uint32_t combined = ((uint32_t)input[0] << 16) | ((uint32_t)input[len >> 1] << 24) | input[len - 1] | ((uint32_t)len << 8);
+        uint64_t bitflip = (hash_read32(secret) ^ hash_read32(secret + 4)) + seed;
+        return hash_avalanche_strong(combined ^ bitflip);
+    }
+
+    return hash_avalanche_strong(seed ^ hash_read64(secret + 56) ^ hash_read64(secret + 64));
+}
+
+static inline uint64_t hash_mix16(const uint8_t *input, const uint8_t *secret, uint64_t seed)
+{
+    return hash_mul_fold(hash_read64(input) ^ (hash_read64(secret) + seed), hash_read64(input + 8) ^ (hash_read64(secret + 8) - seed));
+}
+
+// pairs of 16 bytes from both ends, which overlap for lengths that aren't multiples of 32
+static uint64_t hash_len_17to128(const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed)
+{
+    uint64_t acc = len * HASH_PRIME64_1;
+    if (len > 32)
+    {
+        if (len > 64)
+        {
+            if (len > 96)
+            {
+                acc += hash_mix16(input + 48, secret + 96, seed);
+                acc += hash_mix16(input + len - 64, secret + 112, seed);
+            }
+            acc += hash_mix16(input + 32, secret + 64, seed);
+            acc += hash_mix16(input + len - 48, secret + 80, seed);
+        }
+        acc += hash_mix16(input + 16, secret + 32, seed);
+        acc += hash_mix16(input + len - 32, secret + 48, seed);
+    }
+    acc += hash_mix16(input, secret, seed);
+    acc += hash_mix16(input + len - 16, secret + 16, seed);
+    return hash_avalanche(acc);
+}
+
+static uint64_t hash_len_129to240(const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed)
+{
+    uint64_t acc = len * HASH_PRIME64_1;
+    for (size_t round = 0; round < 8; round++)
+    {
+        acc += hash_mix16(input + 16 * round, secret + 16 * round, seed);
+    }
+    acc = hash_avalanche(acc);
+
+    // the secret only has room for 8 rounds, so the rest reuse it shifted by 3 bytes
+    for (size_t round = 8; round < len / 16; round++)
+    {
+        acc += hash_mix16(input + 16 * round, secret + 16 * (round - 8) + 3, seed);
+    }
+    acc += hash_mix16(input + len - 16, secret + 119, seed);
+    return hash_avalanche(acc);
+}
+
+// reads at most 136 bytes of secret
+static uint64_t hash_short(const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed)
+{
+    if (len <= 16)
+    {
+        return hash_len_0to16(input, len, secret, seed);
+    }
+    return len <= 128 ? hash_len_17to128(input, len, secret, seed) : hash_len_129to240(input, len, secret, seed);
+}
+
+// longer inputs go through 8 lanes of accumulators, a 64 byte stripe at a time, each stripe with the secret
+// shifted a little further; every block of stripes ends by scrambling the accumulators
+
+typedef struct
+{
+    void (*accumulate)(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripe_num);
+    void (*scramble)(uint64_t *acc, const uint8_t *secret);
+} hash_kernels_t;
+
+#ifndef HASH_X86
+
+// x86-64 always has at least SSE2, so the portable kernels are only needed elsewhere
+static void accumulate_scalar(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripe_num)
+{
+    for (size_t stripe = 0; stripe < stripe_num; stripe++)
+    {
+        const uint8_t *stripe_input = input + stripe * HASH_STRIPE_LEN;
+        const uint8_t *stripe_secret = secret + stripe * 8;
+        for (size_t lane = 0; lane < 8; lane++)
+        {
+            uint64_t data = hash_read64(stripe_input + lane * 8);
+            uint64_t data_key = data ^ hash_read64(stripe_secret + lane * 8);
+            acc[lane ^ 1] += data; // the raw data crosses lanes so that no input is lost if the product is 0
+            acc[lane] += (data_key & 0xffffffff) * (data_key >> 32);
+        }
+    }
+}
+
+static void scramble_scalar(uint64_t *acc, const uint8_t *secret)
+{
+    for (size_t lane = 0; lane < 8; lane++)
+    {
+        uint64_t value = acc[lane];
+        value ^= value >> 47;
+        value ^= hash_read64(secret + lane * 8);
+        acc[lane] = value * HASH_PRIME32_1;
+    }
+}
+
+static const hash_kernels_t kernels_hash_scalar = {accumulate_scalar, scramble_scalar};
+
+static const hash_kernels_t *hash_kernels(void)
+{
+    return &kernels_hash_scalar;
+}
+
+#else
+
+// the vector kernels compute exactly what the portable ones do: _mm_mul_epu32 multiplies the low halves of the
+// 64-bit lanes, the shuffles swap the halves of each lane and the 64-bit lanes of each 128-bit pair
+
+static void accumulate_sse2(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripe_num)
+{
+    __m128i lanes[4];
+    for (size_t index = 0; index < 4; index++)
+    {
+        lanes[index] = _mm_loadu_si128((const __m128i *)acc + index);
+    }
+
+    for (size_t stripe = 0; stripe < stripe_num; stripe++)
+    {
+        const uint8_t *stripe_input = input + stripe * HASH_STRIPE_LEN;
+        const uint8_t *stripe_secret = secret + stripe * 8;
+        for (size_t index = 0; index < 4; index++)
+        {
+            __m128i data = _mm_loadu_si128((const __m128i *)stripe_input + index);
+            __m128i data_key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i *)stripe_secret + index));
+            __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[index] = _mm_add_epi64(lanes[index], _mm_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t index = 0; index < 4; index++)
+    {
+        _mm_storeu_si128((__m128i *)acc + index, lanes[index]);
+    }
+}
+
+static void scramble_sse2(uint64_t *acc, const uint8_t *secret)
+{
+    const __m128i prime = _mm_set1_epi32((int)HASH_PRIME32_1);
+    for (size_t index = 0; index < 4; index++)
+    {
+        __m128i value = _mm_loadu_si128((const __m128i *)acc + index);
+        value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+        value = _mm_xor_si128(value, _mm_loadu_si128((const __m128i *)secret + index));
+        __m128i low = _mm_mul_epu32(value, prime);
+        __m128i high = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm_storeu_si128((__m128i *)acc + index, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+    }
+}
+
+__attribute__((target("avx2"))) static void accumulate_avx2(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripe_num)
+{
+    __m256i lanes[2];
+    for (size_t index = 0; index < 2; index++)
+    {
+        lanes[index] = _mm256_loadu_si256((const __m256i *)acc + index);
+    }
+
+    for (size_t stripe = 0; stripe < stripe_num; stripe++)
+    {
+        const uint8_t *stripe_input = input + stripe * HASH_STRIPE_LEN;
+        const uint8_t *stripe_secret = secret + stripe * 8;
+        for (size_t index = 0; index < 2; index++)
+        {
+            __m256i data = _mm256_loadu_si256((const __m256i *)stripe_input + index);
+            __m256i data_key = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i *)stripe_secret + index));
+            __m256i product = _mm256_mul_epu32(data_key, _mm256_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[index] = _mm256_add_epi64(lanes[index], _mm256_add_epi64(product, swapped));
+        }
+    }
+
+    for (size_t index = 0; index < 2; index++)
+    {
+        _mm256_storeu_si256((__m256i *)acc + index, lanes[index]);
+    }
+}
+
+__attribute__((target("avx2"))) static void scramble_avx2(uint64_t *acc, const uint8_t *secret)
+{
+    const __m256i prime = _mm256_set1_epi32((int)HASH_PRIME32_1);
+    for (size_t index = 0; index < 2; index++)
+    {
+        __m256i value = _mm256_loadu_si256((const __m256i *)acc + index);
+        value = _mm256_xor_si256(value, _mm256_srli_epi64(value, 47));
+        value = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i *)secret + index));
+        __m256i low = _mm256_mul_epu32(value, prime);
+        __m256i high = _mm256_mul_epu32(_mm256_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+        _mm256_storeu_si256((__m256i *)acc + index, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+    }
+}
+
+__attribute__((target("avx512f"))) static void accumulate_avx512(uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t stripe_num)
+{
+    __m512i lanes = _mm512_loadu_si512((const void *)acc);
+    for (size_t stripe = 0; stripe < stripe_num; stripe++)
+    {
+        __m512i data = _mm512_loadu_si512((const void *)(input + stripe * HASH_STRIPE_LEN));
+        __m512i data_key = _mm512_xor_si512(data, _mm512_loadu_si512((const void *)(secret + stripe * 8)));
+        __m512i product = _mm512_mul_epu32(data_key, _mm512_shuffle_epi32(data_key, (_MM_PERM_ENUM)_MM_SHUFFLE(0, 3, 0, 1)));
+        __m512i swapped = _mm512_shuffle_epi32(data, (_MM_PERM_ENUM)_MM_SHUFFLE(1, 0, 3, 2));
+        lanes = _mm512_add_epi64(lanes, _mm512_add_epi64(product, swapped));
+    }
+    _mm512_storeu_si512((void *)acc, lanes);
+}
+
+__attribute__((target("avx512f"))) static void scramble_avx512(uint64_t *acc, const uint8_t *secret)
+{
+    const __m512i prime = _mm512_set1_epi32((int)HASH_PRIME32_1);
+    __m512i value = _mm512_loadu_si512((const void *)acc);
+    value = _mm512_xor_si512(value, _mm512_srli_epi64(value, 47));
+    value = _mm512_xor_si512(value, _mm512_loadu_si512((const void *)secret));
+    __m512i low = _mm512_mul_epu32(value, prime);
+    __m512i high = _mm512_mul_epu32(_mm512_shuffle_epi32(value, (_MM_PERM_ENUM)_MM_SHUFFLE(0, 3, 0, 1)), prime);
+    _mm512_storeu_si512((void *)acc, _mm512_add_epi64(low, _mm512_slli_epi64(high, 32)));
+}
+
+static const hash_kernels_t kernels_hash_sse2 = {accumulate_sse2, scramble_sse2};
+static const hash_kernels_t kernels_hash_avx2 = {accumulate_avx2, scramble_avx2};
+static const hash_kernels_t kernels_hash_avx512 = {accumulate_avx512, scramble_avx512};
+
+// picks the widest kernels the CPU supports, probing it only once
+static const hash_kernels_t *hash_kernels(void)
+{
+    static _Atomic(const hash_kernels_t *) selected = NULL;
+
+    const hash_kernels_t *kernels = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (!kernels)
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+        {
+            kernels = &kernels_hash_avx512;
+        }
+        else
+        {
+            kernels = __builtin_cpu_supports("avx2") ? &kernels_hash_avx2 : &kernels_hash_sse2;
+        }
+        atomic_store_explicit(&selected, kernels, memory_order_relaxed); // racing first calls store the same value
+    }
+
+    return kernels;
+}
+
+#endif
+
+static void hash_init_acc(uint64_t *acc)
+{
+    const uint64_t init[8] = {HASH_PRIME32_3, HASH_PRIME64_1, HASH_PRIME64_2, HASH_PRIME64_3,
+                              HASH_PRIME64_4, HASH_PRIME32_2, HASH_PRIME64_5, HASH_PRIME32_1};
+    memcpy(acc, init, sizeof(init));
+}
+
+// a seeded long hash runs on a secret of its own, which keeps the stripe loop free of the seed
+static void hash_derive_secret(uint8_t *secret, uint64_t seed)
+{
+    for (size_t index = 0; index < HASH_SECRET_LEN; index += 16)
+    {
+        hash_write64(secret + index, hash_read64(hash_secret + index) + seed);
+        hash_write64(secret + index + 8, hash_read64(hash_secret + index + 8) - seed);
+    }
+}
+
+// feeds whole stripes to the accumulators, scrambling them whenever a block fills up
+static void hash_consume(uint64_t *acc, size_t *block_stripe, const uint8_t *input, size_t stripe_num, const uint8_t *secret,
+                         const hash_kernels_t *kernels)
+{
+    while (stripe_num)
+    {
+        size_t take = HASH_STRIPES_PER_BLOCK - *block_stripe;
+        if (take > stripe_num)
+        {
+            take = stripe_num;
+        }
+
+        kernels->accumulate(acc, input, secret + *block_stripe * 8, take);
+        input += take * HASH_STRIPE_LEN;
+        stripe_num -= take;
+        *block_stripe += take;
+
+        if (*block_stripe == HASH_STRIPES_PER_BLOCK)
+        {
+            kernels->scramble(acc, secret + HASH_SCRAMBLE_OFFSET);
+            *block_stripe = 0;
+        }
+    }
+}
+
+static uint64_t hash_merge(const uint64_t *acc, const uint8_t *secret, uint64_t start)
+{
+    uint64_t result = start;
+    for (size_t index = 0; index < 4; index++)
+    {
+        result += hash_mul_fold(acc[2 * index] ^ hash_read64(secret + 16 * index), acc[2 * index + 1] ^ hash_read64(secret + 16 * index + 8));
+    }
+    return hash_avalanche(result);
+}
+
+// runs every stripe but the last through the accumulators, then the last 64 bytes of input,
+// which overlap the stripe before them unless len is a multiple of 64
+static void hash_long(uint64_t *acc, const uint8_t *input, size_t len, const uint8_t *secret)
+{
+    const hash_kernels_t *kernels = hash_kernels();
+    size_t block_stripe = 0;
+    hash_init_acc(acc);
+    hash_consume(acc, &block_stripe, input, (len - 1) / HASH_STRIPE_LEN, secret, kernels);
+    kernels->accumulate(acc, input + len - HASH_STRIPE_LEN, secret + HASH_LAST_STRIPE_OFFSET, 1);
+}
+
+static uint64_t hash_digest_low(const uint64_t *acc, const uint8_t *secret, uint64_t len)
+{
+    return hash_merge(acc, secret + 11, len * HASH_PRIME64_1);
+}
+
+static uint64_t hash_digest_high(const uint64_t *acc, const uint8_t *secret, uint64_t len)
+{
+    return hash_merge(acc, secret + HASH_SECRET_LEN - HASH_STRIPE_LEN - 11, ~(len * HASH_PRIME64_2));
+}
+
+static strix_hash128_t hash_short128(const uint8_t *input, size_t len, uint64_t seed)
+{
+    strix_hash128_t hash = {hash_short(input, len, hash_secret, seed), hash_short(input, len, hash_secret + HASH_HIGH_OFFSET, ~seed)};
+    return hash;
+}
+
+uint64_t strix_hash64(const void *data, size_t len, uint64_t seed)
+{
+    if (!data && len)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    const uint8_t *input = (const uint8_t *)data;
+    if (len <= HASH_SHORT_MAX)
+    {
+        return hash_short(input, len, hash_secret, seed);
+    }
+
+    uint8_t seeded_secret[HASH_SECRET_LEN];
+    const uint8_t *secret = hash_secret;
+    if (seed)
+    {
+        hash_derive_secret(seeded_secret, seed);
+        secret = seeded_secret;
+    }
+
+    uint64_t acc[8];
+    hash_long(acc, input, len, secret);
+    return hash_digest_low(acc, secret, len);
+}
+
+strix_hash128_t strix_hash128(const void *data, size_t len, uint64_t seed)
+{
+    strix_hash128_t hash = {0, 0};
+    if (!data && len)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return hash;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    const uint8_t *input = (const uint8_t *)data;
+    if (len <= HASH_SHORT_MAX)
+    {
+        return hash_short128(input, len, seed);
+    }
+
+    uint8_t seeded_secret[HASH_SECRET_LEN];
+    const uint8_t *secret = hash_secret;
+    if (seed)
+    {
+        hash_derive_secret(seeded_secret, seed);
+        secret = seeded_secret;
+    }
+
+    uint64_t acc[8];
+    hash_long(acc, input, len, secret);
+    hash.low = hash_digest_low(acc, secret, len);
+    hash.high = hash_digest_high(acc, secret, len);
+    return hash;
+}
+
+uint64_t strix_hash(const strix_t *strix, uint64_t seed)
+{
+    if (!strix)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    return strix_hash64(strix_str(strix), strix_len(strix), seed);
+}
+
+uint64_t strix_view_hash(strix_view_t view, uint64_t seed)
+{
+    return strix_hash64(view.str, view.len, seed);
+}
+
+bool strix_hash_init(strix_hash_state_t *state, uint64_t seed)
+{
+    if (!state)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    hash_init_acc(state->acc);
+    hash_derive_secret(state->secret, seed);
+    state->seed = seed;
+    state->total_len = 0;
+    state->buffered = 0;
+    state->block_stripe = 0;
+    return true;
+}
+
+// input is only consumed once more of it arrives, so the buffer never ends up empty while anything was hashed;
+// the digest needs the last stripe, and the short hash needs all of an input of up to HASH_SHORT_MAX bytes
+bool strix_hash_update(strix_hash_state_t *state, const void *data, size_t len)
+{
+    if (!state || (!data && len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    const uint8_t *input = (const uint8_t *)data;
+    state->total_len += len;
+    if (state->buffered + len <= HASH_BUFFER_LEN)
+    {
+        if (len)
+        {
+            memcpy(state->buffer + state->buffered, input, len);
+        }
+        state->buffered += len;
+        return true;
+    }
+
+    const hash_kernels_t *kernels = hash_kernels();
+    if (state->buffered)
+    {
+        size_t fill = HASH_BUFFER_LEN - state->buffered;
+        memcpy(state->buffer + state->buffered, input, fill);
+        input += fill;
+        len -= fill;
+        hash_consume(state->acc, &state->block_stripe, state->buffer, HASH_BUFFER_LEN / HASH_STRIPE_LEN, state->secret, kernels);
+        state->buffered = 0;
+    }
+
+    // whole buffers' worth of input skip the copy
+    if (len > HASH_BUFFER_LEN)
+    {
+        size_t stripe_num = (len - 1) / HASH_STRIPE_LEN;
+        hash_consume(state->acc, &state->block_stripe, input, stripe_num, state->secret, kernels);
+        input += stripe_num * HASH_STRIPE_LEN;
+        len -= stripe_num * HASH_STRIPE_LEN;
+
+        // the end of the buffer keeps the last stripe consumed, in case the rest is too short to complete the final one
+        memcpy(state->buffer + HASH_BUFFER_LEN - HASH_STRIPE_LEN, input - HASH_STRIPE_LEN, HASH_STRIPE_LEN);
+    }
+
+    memcpy(state->buffer, input, len);
+    state->buffered = len;
+    return true;
+}
+
+// finishes a copy of the accumulators, so that the state can take more input after a digest
+static void hash_state_long(const strix_hash_state_t *state, uint64_t *acc)
+{
+    const hash_kernels_t *kernels = hash_kernels();
+    size_t block_stripe = state->block_stripe;
+    memcpy(acc, state->acc, sizeof(state->acc));
+    hash_consume(acc, &block_stripe, state->buffer, (state->buffered - 1) / HASH_STRIPE_LEN, state->secret, kernels);
+
+    const uint8_t *last_stripe = state->buffer + state->buffered - HASH_STRIPE_LEN;
+    uint8_t joined[HASH_STRIPE_LEN];
+    if (state->buffered < HASH_STRIPE_LEN)
+    {
+        size_t catchup = HASH_STRIPE_LEN - state->buffered;
+        memcpy(joined, state->buffer + HASH_BUFFER_LEN - catchup, catchup);
+        memcpy(joined + catchup, state->buffer, state->buffered);
+        last_stripe = joined;
+    }
+
+    kernels->accumulate(acc, last_stripe, state->secret + HASH_LAST_STRIPE_OFFSET, 1);
+}
+
+uint64_t strix_hash_digest64(const strix_hash_state_t *state)
+{
+    if (!state)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    if (state->total_len <= HASH_SHORT_MAX)
+    {
+        return hash_short(state->buffer, (size_t)state->total_len, hash_secret, state->seed);
+    }
+
+    uint64_t acc[8];
+    hash_state_long(state, acc);
+    return hash_digest_low(acc, state->secret, state->total_len);
+}
+
+strix_hash128_t strix_hash_digest128(const strix_hash_state_t *state)
+{
+    strix_hash128_t hash = {0, 0};
+    if (!state)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return hash;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    if (state->total_len <= HASH_SHORT_MAX)
+    {
+        return hash_short128(state->buffer, (size_t)state->total_len, state->seed);
+    }
+
+    uint64_t acc[8];
+    hash_state_long(state, acc);
+    hash.low = hash_digest_low(acc, state->secret, state->total_len);
+    hash.high = hash_digest_high(acc, state->secret, state->total_len);
+    return hash;
+}
+
+bool strix_hash_file(const char *file_path, uint64_t seed, uint64_t *hash)
+{
+    if (!file_path || !hash)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
+    {
+        strix_errno = STRIX_ERR_STDIO;
+        return false;
+    }
+
+    strix_hash_state_t state;
+    strix_hash_init(&state, seed);
+
+    uint8_t buffer[1 << 16];
+    ssize_t bytes_read;
+    while ((bytes_read = read(fd, buffer, sizeof(buffer))) != 0)
+    {
+        if (bytes_read == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            int saved_errno = errno;
+            close(fd);
+            errno = saved_errno;
+            strix_errno = STRIX_ERR_STDIO;
+            return false;
+        }
+
+        strix_hash_update(&state, buffer, (size_t)bytes_read);
+    }
+
+    close(fd);
+    *hash = strix_hash_digest64(&state);
+    return true;
+}
+
+// CRC32C (the Castagnoli polynomial, reflected), a byte at a time
+static const uint32_t crc32c_table[256] = {
+    0x00000000, 0xf26b8303, 0xe13b70f7, 0x1350f3f4, 0xc79a971f, 0x35f1141c, 0x26a1e7e8, 0xd4ca64eb,
+    0x8ad958cf, 0x78b2dbcc, 0x6be22838, 0x9989ab3b, 0x4d43cfd0, 0xbf284cd3, 0xac78bf27, 0x5e133c24,
+    0x105ec76f, 0xe235446c, 0xf165b798, 0x030e349b, 0xd7c45070, 0x25afd373, 0x36ff2087, 0xc494a384,
+    0x9a879fa0, 0x68ec1ca3, 0x7bbcef57, 0x89d76c54, 0x5d1d08bf, 0xaf768bbc, 0xbc267848, 0x4e4dfb4b,
+    0x20bd8ede, 0xd2d60ddd, 0xc186fe29, 0x33ed7d2a, 0xe72719c1, 0x154c9ac2, 0x061c6936, 0xf477ea35,
+    0xaa64d611, 0x580f5512, 0x4b5fa6e6, 0xb93425e5, 0x6dfe410e, 0x9f95c20d, 0x8cc531f9, 0x7eaeb2fa,
+    0x30e349b1, 0xc288cab2, 0xd1d83946, 0x23b3ba45, 0xf779deae, 0x05125dad, 0x1642ae59, 0xe4292d5a,
+    0xba3a117e, 0x4851927d, 0x5b016189, 0xa96ae28a, 0x7da08661, 0x8fcb0562, 0x9c9bf696, 0x6ef07595,
+    0x417b1dbc, 0xb3109ebf, 0xa0406d4b, 0x522bee48, 0x86e18aa3, 0x748a09a0, 0x67dafa54, 0x95b17957,
+    0xcba24573, 0x39c9c670, 0x2a993584, 0xd8f2b687, 0x0c38d26c, 0xfe53516f, 0xed03a29b, 0x1f682198,
+    0x5125dad3, 0xa34e59d0, 0xb01eaa24, 0x42752927, 0x96bf4dcc, 0x64d4cecf, 0x77843d3b, 0x85efbe38,
+    0xdbfc821c, 0x2997011f, 0x3ac7f2eb, 0xc8ac71e8, 0x1c661503, 0xee0d9600, 0xfd5d65f4, 0x0f36e6f7,
+    0x61c69362, 0x93ad1061, 0x80fde395, 0x72966096, 0xa65c047d, 0x5437877e, 0x4767748a, 0xb50cf789,
+    0xeb1fcbad, 0x197448ae, 0x0a24bb5a, 0xf84f3859, 0x2c855cb2, 0xdeeedfb1, 0xcdbe2c45, 0x3fd5af46,
+    0x7198540d, 0x83f3d70e, 0x90a324fa, 0x62c8a7f9, 0xb602c312, 0x44694011, 0x5739b3e5, 0xa55230e6,
+    0xfb410cc2, 0x092a8fc1, 0x1a7a7c35, 0xe811ff36, 0x3cdb9bdd, 0xceb018de, 0xdde0eb2a, 0x2f8b6829,
+    0x82f63b78, 0x709db87b, 0x63cd4b8f, 0x91a6c88c, 0x456cac67, 0xb7072f64, 0xa457dc90, 0x563c5f93,
+    0x082f63b7, 0xfa44e0b4, 0xe9141340, 0x1b7f9043, 0xcfb5f4a8, 0x3dde77ab, 0x2e8e845f, 0xdce5075c,
+    0x92a8fc17, 0x60c37f14, 0x73938ce0, 0x81f80fe3, 0x55326b08, 0xa759e80b, 0xb4091bff, 0x466298fc,
+    0x1871a4d8, 0xea1a27db, 0xf94ad42f, 0x0b21572c, 0xdfeb33c7, 0x2d80b0c4, 0x3ed04330, 0xccbbc033,
+    0xa24bb5a6, 0x502036a5, 0x4370c551, 0xb11b4652, 0x65d122b9, 0x97baa1ba, 0x84ea524e, 0x7681d14d,
+    0x2892ed69, 0xdaf96e6a, 0xc9a99d9e, 0x3bc21e9d, 0xef087a76, 0x1d63f975, 0x0e330a81, 0xfc588982,
+    0xb21572c9, 0x407ef1ca, 0x532e023e, 0xa145813d, 0x758fe5d6, 0x87e466d5, 0x94b49521, 0x66df1622,
+    0x38cc2a06, 0xcaa7a905, 0xd9f75af1, 0x2b9cd9f2, 0xff56bd19, 0x0d3d3e1a, 0x1e6dcdee, 0xec064eed,
+    0xc38d26c4, 0x31e6a5c7, 0x22b65633, 0xd0ddd530, 0x0417b1db, 0xf67c32d8, 0xe52cc12c, 0x1747422f,
+    0x49547e0b, 0xbb3ffd08, 0xa86f0efc, 0x5a048dff, 0x8ecee914, 0x7ca56a17, 0x6ff599e3, 0x9d9e1ae0,
+    0xd3d3e1ab, 0x21b862a8, 0x32e8915c, 0xc083125f, 0x144976b4, 0xe622f5b7, 0xf5720643, 0x07198540,
+    0x590ab964, 0xab613a67, 0xb831c993, 0x4a5a4a90, 0x9e902e7b, 0x6cfbad78, 0x7fab5e8c, 0x8dc0dd8f,
+    0xe330a81a, 0x115b2b19, 0x020bd8ed, 0xf0605bee, 0x24aa3f05, 0xd6c1bc06, 0xc5914ff2, 0x37faccf1,
+    0x69e9f0d5, 0x9b8273d6, 0x88d28022, 0x7ab90321, 0xae7367ca, 0x5c18e4c9, 0x4f48173d, 0xbd23943e,
+    0xf36e6f75, 0x0105ec76, 0x12551f82, 0xe03e9c81, 0x34f4f86a, 0xc69f7b69, 0xd5cf889d, 0x27a40b9e,
+    0x79b737ba, 0x8bdcb4b9, 0x988c474d, 0x6ae7c44e, 0xbe2da0a5, 0x4c4623a6, 0x5f16d052, 0xad7d5351,
+};
+
+typedef uint32_t (*crc32c_kernel_t)(uint32_t crc, const uint8_t *bytes, size_t len);
+
+// both kernels work on the inverted register; strix_crc32c inverts on the way in and out
+static uint32_t crc32c_table_kernel(uint32_t crc, const uint8_t *bytes, size_t len)
+{
+    for (size_t index = 0; index < len; index++)
+    {
+        crc = (crc >> 8) ^ crc32c_table[(crc ^ bytes[index]) & 0xff];
+    }
+    return crc;
+}
+
+#ifdef HASH_X86
+
+__attribute__((target("sse4.2"))) static uint32_t crc32c_sse42(uint32_t crc, const uint8_t *bytes, size_t len)
+{
+    uint64_t crc64 = crc;
+    for (; len >= 8; bytes += 8, len -= 8)
+    {
+        crc64 = _mm_crc32_u64(crc64, hash_read64(bytes));
+    }
+
+    crc = (uint32_t)crc64;
+    for (; len; bytes++, len--)
+    {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+    return crc;
+}
+
+static crc32c_kernel_t crc32c_kernel(void)
+{
+    static _Atomic(crc32c_kernel_t) selected = NULL;
+
+    crc32c_kernel_t kernel = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (!kernel)
+    {
+        __builtin_cpu_init();
+        kernel = __builtin_cpu_supports("sse4.2") ? crc32c_sse42 : crc32c_table_kernel;
+        atomic_store_explicit(&selected, kernel, memory_order_relaxed);
+    }
+
+    return kernel;
+}
+
+#else
+
+static crc32c_kernel_t crc32c_kernel(void)
+{
+    return crc32c_table_kernel;
+}
+
+#endif
+
+uint32_t strix_crc32c(uint32_t crc, const void *data, size_t len)
+{
+    if (!data && len)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return crc;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+    return ~crc32c_kernel()(~crc, (const uint8_t *)data, len);
+}
+
+#undef HASH_X86
+#undef HASH_STRIPE_LEN
+#undef HASH_SECRET_LEN
+#undef HASH_BUFFER_LEN
+#undef HASH_STRIPES_PER_BLOCK
+#undef HASH_SHORT_MAX
+#undef HASH_SCRAMBLE_OFFSET
+#undef HASH_LAST_STRIPE_OFFSET
+#undef HASH_HIGH_OFFSET
+#undef HASH_PRIME32_1
+#undef HASH_PRIME32_2
+#undef HASH_PRIME32_3
+#undef HASH_PRIME64_1
+#undef HASH_PRIME64_2
+#undef HASH_PRIME64_3
+#undef HASH_PRIME64_4
+#undef HASH_PRIME64_5
@@ -0,0 +1,291 @@
+#include "../header/strix.h"
+#include "../allocator/allocator.h"
+
+#define INTERN_BLOCK_LEN (64 * 1024) // strings longer than a quarter of this get a block of their own
+#define INTERN_NONE UINT32_MAX
+
+// the strings live in a chain of blocks that are never moved or freed before the table is
+typedef struct intern_block
+{
+    struct intern_block *next;
+    size_t used;
+    size_t size;
+    char data[];
+} intern_block_t;
+
+typedef struct
+{
+    const char *str; // null terminated copy in the arena
+    size_t len;
+    uint64_t hash;
+} intern_string_t;
+
+struct strix_intern
+{
+    intern_string_t *strings; // indexed by id, in insertion order
+    size_t count;
+    size_t strings_capacity;
+    uint32_t *slots; // ids, or INTERN_NONE for an empty slot
+    size_t slot_num; // always a power of two
+    intern_block_t *blocks;
+};
+
+strix_intern_t *strix_intern_create(void)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    strix_intern_t *table = (strix_intern_t *)allocate(sizeof(strix_intern_t));
+    if (!table)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+
+    table->count = 0;
+    table->strings_capacity = 64;
+    table->slot_num = 128;
+    table->blocks = NULL;
+    table->strings = (intern_string_t *)allocate(sizeof(intern_string_t) * table->strings_capacity);
+    table->slots = (uint32_t *)allocate(sizeof(uint32_t) * table->slot_num);
+    if (!table->strings || !table->slots)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        strix_intern_free(table);
+        return NULL;
+    }
+    memset(table->slots, 0xff, sizeof(uint32_t) * table->slot_num);
+
+    return table;
+}
+
+void strix_intern_free(strix_intern_t *table)
+{
+    if (!table)
+    {
+        return;
+    }
+
+    for (intern_block_t *block = table->blocks; block;)
+    {
+        intern_block_t *next = block->next;
+        deallocate(block);
+        block = next;
+    }
+
+    // not every deallocator accepts NULL, and a table whose creation failed may lack either array
+    if (table->strings)
+    {
+        deallocate(table->strings);
+    }
+    if (table->slots)
+    {
+        deallocate(table->slots);
+    }
+    deallocate(table);
+}
+
+// the slot holding view, or the empty slot where it belongs
+static uint32_t *intern_slot(const strix_intern_t *table, strix_view_t view, uint64_t hash)
+{
+    size_t index = hash & (table->slot_num - 1);
+    while (table->slots[index] != INTERN_NONE)
+    {
+        const intern_string_t *string = &table->strings[table->slots[index]];
+        if (string->hash == hash && string->len == view.len && (!view.len || !memcmp(string->str, view.str, view.len)))
+        {
+            break;
+        }
+        index = (index + 1) & (table->slot_num - 1);
+    }
+
+    return &table->slots[index];
+}
+
+// doubles the slots; the ids and strings stay where they are
+static bool intern_grow_slots(strix_intern_t *table)
+{
+    size_t slot_num = table->slot_num * 2;
+    uint32_t *slots = (uint32_t *)allocate(sizeof(uint32_t) * slot_num);
+    if (!slots)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return false;
+    }
+    memset(slots, 0xff, sizeof(uint32_t) * slot_num);
+
+    for (size_t id = 0; id < table->count; id++)
+    {
+        size_t index = table->strings[id].hash & (slot_num - 1);
+        while (slots[index] != INTERN_NONE)
+        {
+            index = (index + 1) & (slot_num - 1);
+        }
+        slots[index] = (uint32_t)id;
+    }
+
+    deallocate(table->slots);
+    table->slots = slots;
+    table->slot_num = slot_num;
+    return true;
+}
+
+static bool intern_grow_strings(strix_intern_t *table)
+{
+    size_t capacity = table->strings_capacity * 2;
+    intern_string_t *strings = (intern_string_t *)allocate(sizeof(intern_string_t) * capacity);
+    if (!strings)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return false;
+    }
+
+    memcpy(strings, table->strings, sizeof(intern_string_t) * table->count);
+    deallocate(table->strings);
+    table->strings = strings;
+    table->strings_capacity = capacity;
+    return true;
+}
+
+// copies view and a terminator into the arena
+static const char *intern_copy(strix_intern_t *table, strix_view_t view)
+{
+    size_t size = view.len + 1;
+    intern_block_t *block = table->blocks;
+    if (!block || block->size - block->used < size)
+    {
+        // a long string gets a block of its own behind the current one, which keeps its free space
+        bool own_block = size > INTERN_BLOCK_LEN / 4;
+        size_t block_size = own_block ? size : INTERN_BLOCK_LEN;
+        intern_block_t *new_block = (intern_block_t *)allocate(sizeof(intern_block_t) + block_size);
+        if (!new_block)
+        {
+            strix_errno = STRIX_ERR_MALLOC_FAILED;
+            return NULL;
+        }
+        new_block->used = 0;
+        new_block->size = block_size;
+
+        if (own_block && block)
+        {
+            new_block->next = block->next;
+            block->next = new_block;
+        }
+        else
+        {
+            new_block->next = block;
+            table->blocks = new_block;
+        }
+        block = new_block;
+    }
+
+    char *copy = block->data + block->used;
+    memcpy(copy, view.str, view.len);
+    copy[view.len] = 0;
+    block->used += size;
+    return copy;
+}
+
+int64_t strix_intern_id(strix_intern_t *table, strix_view_t view)
+{
+    if (!table || (!view.str && view.len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    uint64_t hash = strix_view_hash(view, 0);
+    uint32_t *slot = intern_slot(table, view, hash);
+    if (*slot != INTERN_NONE)
+    {
+        return *slot;
+    }
+
+    if (table->count == INTERN_NONE)
+    {
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
+        return -1;
+    }
+
+    // keep the load factor under 0.75; growing moves the slot
+    if ((table->count + 1) * 4 > table->slot_num * 3)
+    {
+        if (!intern_grow_slots(table))
+        {
+            return -1;
+        }
+        slot = intern_slot(table, view, hash);
+    }
+
+    if (table->count == table->strings_capacity && !intern_grow_strings(table))
+    {
+        return -1;
+    }
+
+    const char *copy = intern_copy(table, view);
+    if (!copy)
+    {
+        return -1;
+    }
+
+    intern_string_t *string = &table->strings[table->count];
+    string->str = copy;
+    string->len = view.len;
+    string->hash = hash;
+    *slot = (uint32_t)table->count;
+    return (int64_t)table->count++;
+}
+
+const char *strix_intern(strix_intern_t *table, strix_view_t view)
+{
+    int64_t id = strix_intern_id(table, view);
+    return id < 0 ? NULL : table->strings[id].str;
+}
+
+const char *strix_intern_cstr(strix_intern_t *table, const char *str)
+{
+    if (!str)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return NULL;
+    }
+
+    return strix_intern(table, strix_view_from_cstr(str));
+}
+
+int64_t strix_intern_find(const strix_intern_t *table, strix_view_t view)
+{
+    if (!table || (!view.str && view.len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    uint32_t id = *intern_slot(table, view, strix_view_hash(view, 0));
+    return id == INTERN_NONE ? -2 : (int64_t)id;
+}
+
+strix_view_t strix_intern_get(const strix_intern_t *table, size_t id)
+{
+    if (!table || id >= table->count)
+    {
+        strix_errno = table ? STRIX_ERR_OUT_OF_BOUNDS_ACCESS : STRIX_ERR_NULL_PTR;
+        strix_view_t none = {NULL, 0};
+        return none;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+    strix_view_t view = {table->strings[id].str, table->strings[id].len};
+    return view;
+}
+
+size_t strix_intern_count(const strix_intern_t *table)
+{
+    return table ? table->count : 0;
+}
+
+#undef INTERN_BLOCK_LEN
+#undef INTERN_NONE
@@ -1,3 +1,9 @@
 #include "string_search.c"
+#include "char_class.c"
 #include "strix.c"
+#include "strix_view.c"
+#include "multi_search.c"
+#include "intern.c"
+#include "hash.c"
+#include "number.c"
 #include "strix_errno.c"
\ No newline at end of file
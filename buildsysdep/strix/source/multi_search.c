@@ -0,0 +1,336 @@
+#include "../header/strix.h"
+#include "../allocator/allocator.h"
+
+#define MULTI_NONE UINT32_MAX
+#define MULTI_MATCH_FLAG 0x80000000u // set on transitions into states that end at least one pattern
+
+struct strix_multi_pattern
+{
+    uint32_t *delta;         // state_num rows of class_num transitions; once built, each holds its target's row offset
+    uint32_t *first_id;      // per state: the first pattern ending exactly there, or MULTI_NONE
+    uint32_t *next_id;       // per pattern: the next pattern ending at the same state (duplicates), or MULTI_NONE
+    uint32_t *out_link;      // per state: the longest proper suffix state ending a pattern, or MULTI_NONE
+    size_t *pattern_len_arr; // per pattern: its length
+    size_t pattern_num;
+    size_t state_num;
+    size_t class_num;
+    uint16_t class_of[256]; // bytes that appear in no pattern share class 0, so rows stay short
+    bool starts[256];       // bytes that begin some pattern; the only ones leading out of the root
+};
+
+// not every deallocator accepts NULL, and partially built automata have NULL members
+static void multi_deallocate(void *ptr)
+{
+    if (ptr)
+    {
+        deallocate(ptr);
+    }
+}
+
+void strix_multi_pattern_free(strix_multi_pattern_t *multi)
+{
+    if (!multi)
+    {
+        return;
+    }
+
+    multi_deallocate(multi->delta);
+    multi_deallocate(multi->first_id);
+    multi_deallocate(multi->next_id);
+    multi_deallocate(multi->out_link);
+    multi_deallocate(multi->pattern_len_arr);
+    deallocate(multi);
+}
+
+// adds the patterns to a trie in multi->delta, whose absent children are 0 (the root is never a child)
+static void multi_build_trie(strix_multi_pattern_t *multi, const char **patterns)
+{
+    multi->state_num = 1;
+    for (size_t id = 0; id < multi->pattern_num; id++)
+    {
+        uint32_t state = 0;
+        for (size_t index = 0; index < multi->pattern_len_arr[id]; index++)
+        {
+            uint32_t *next = &multi->delta[state * multi->class_num + multi->class_of[(unsigned char)patterns[id][index]]];
+            if (!*next)
+            {
+                *next = (uint32_t)multi->state_num++;
+            }
+            state = *next;
+        }
+
+        // a duplicate pattern is chained behind the earlier one
+        multi->next_id[id] = multi->first_id[state];
+        multi->first_id[state] = (uint32_t)id;
+    }
+}
+
+// turns the trie into a complete automaton, following failure links breadth first
+static bool multi_build_links(strix_multi_pattern_t *multi)
+{
+    size_t class_num = multi->class_num;
+    uint32_t *fail = (uint32_t *)allocate(sizeof(uint32_t) * multi->state_num);
+    uint32_t *queue = (uint32_t *)allocate(sizeof(uint32_t) * multi->state_num);
+    if (!fail || !queue)
+    {
+        multi_deallocate(fail);
+        multi_deallocate(queue);
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return false;
+    }
+
+    size_t head = 0;
+    size_t tail = 0;
+    fail[0] = 0;
+    multi->out_link[0] = MULTI_NONE;
+    for (size_t chr_class = 0; chr_class < class_num; chr_class++)
+    {
+        uint32_t child = multi->delta[chr_class];
+        if (child)
+        {
+            fail[child] = 0;
+            multi->out_link[child] = MULTI_NONE;
+            queue[tail++] = child;
+        }
+    }
+
+    // a row still holds only trie children when its state is dequeued; the rows of shallower states are already complete
+    while (head < tail)
+    {
+        uint32_t state = queue[head++];
+        uint32_t *row = &multi->delta[state * class_num];
+        const uint32_t *fail_row = &multi->delta[fail[state] * class_num];
+
+        for (size_t chr_class = 0; chr_class < class_num; chr_class++)
+        {
+            uint32_t child = row[chr_class];
+            if (!child)
+            {
+                row[chr_class] = fail_row[chr_class];
+                continue;
+            }
+
+            uint32_t child_fail = fail_row[chr_class];
+            fail[child] = child_fail;
+            multi->out_link[child] = multi->first_id[child_fail] != MULTI_NONE ? child_fail : multi->out_link[child_fail];
+            queue[tail++] = child;
+        }
+    }
+
+    deallocate(fail);
+    deallocate(queue);
+
+    // targets become row offsets, sparing the scan a multiplication on its critical path
+    for (size_t index = 0; index < multi->state_num * class_num; index++)
+    {
+        uint32_t target = multi->delta[index];
+        bool matches = multi->first_id[target] != MULTI_NONE || multi->out_link[target] != MULTI_NONE;
+        multi->delta[index] = (uint32_t)(target * class_num) | (matches ? MULTI_MATCH_FLAG : 0);
+    }
+
+    return true;
+}
+
+strix_multi_pattern_t *strix_multi_pattern_compile(const char **patterns, size_t pattern_num)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (!patterns || !pattern_num)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return NULL;
+    }
+
+    strix_multi_pattern_t *multi = (strix_multi_pattern_t *)allocate(sizeof(strix_multi_pattern_t));
+    if (!multi)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+    memset(multi, 0, sizeof(strix_multi_pattern_t));
+    multi->pattern_num = pattern_num;
+
+    multi->pattern_len_arr = (size_t *)allocate(sizeof(size_t) * pattern_num);
+    if (!multi->pattern_len_arr)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        strix_multi_pattern_free(multi);
+        return NULL;
+    }
+
+    // one class per distinct pattern byte, plus class 0 for every other byte
+    bool used[256] = {false};
+    size_t total_len = 0;
+    for (size_t id = 0; id < pattern_num; id++)
+    {
+        if (!patterns[id] || !*patterns[id])
+        {
+            strix_errno = patterns[id] ? STRIX_ERR_EMPTY_STRING : STRIX_ERR_NULL_PTR;
+            strix_multi_pattern_free(multi);
+            return NULL;
+        }
+
+        multi->pattern_len_arr[id] = strlen(patterns[id]);
+        total_len += multi->pattern_len_arr[id];
+        multi->starts[(unsigned char)patterns[id][0]] = true;
+        for (const char *chr = patterns[id]; *chr; chr++)
+        {
+            used[(unsigned char)*chr] = true;
+        }
+    }
+
+    multi->class_num = 1;
+    for (size_t chr = 0; chr < 256; chr++)
+    {
+        multi->class_of[chr] = used[chr] ? (uint16_t)multi->class_num++ : 0;
+    }
+
+    // a trie never has more states than pattern bytes plus the root; row offsets must leave the flag bit free
+    size_t max_states = total_len + 1;
+    if (max_states >= MULTI_MATCH_FLAG / multi->class_num)
+    {
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
+        strix_multi_pattern_free(multi);
+        return NULL;
+    }
+
+    multi->delta = (uint32_t *)allocate(sizeof(uint32_t) * max_states * multi->class_num);
+    multi->first_id = (uint32_t *)allocate(sizeof(uint32_t) * max_states);
+    multi->out_link = (uint32_t *)allocate(sizeof(uint32_t) * max_states);
+    multi->next_id = (uint32_t *)allocate(sizeof(uint32_t) * pattern_num);
+    if (!multi->delta || !multi->first_id || !multi->out_link || !multi->next_id)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        strix_multi_pattern_free(multi);
+        return NULL;
+    }
+    memset(multi->delta, 0, sizeof(uint32_t) * max_states * multi->class_num);
+    memset(multi->first_id, 0xff, sizeof(uint32_t) * max_states);
+
+    multi_build_trie(multi, patterns);
+    if (!multi_build_links(multi))
+    {
+        strix_multi_pattern_free(multi);
+        return NULL;
+    }
+
+    return multi;
+}
+
+size_t strix_multi_pattern_num(const strix_multi_pattern_t *multi)
+{
+    return multi ? multi->pattern_num : 0;
+}
+
+int64_t strix_multi_pattern_scan(const strix_multi_pattern_t *multi, strix_view_t view, strix_match_callback_t callback, void *context)
+{
+    if (!multi || (!view.str && view.len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    const uint32_t *delta = multi->delta;
+    size_t class_num = multi->class_num;
+    int64_t match_num = 0;
+    uint32_t row = 0;
+    for (size_t index = 0; index < view.len; index++)
+    {
+        // at the root, bytes that start no pattern lead back to the root; skipping them needs no table walk
+        if (!row)
+        {
+            while (index < view.len && !multi->starts[(unsigned char)view.str[index]])
+            {
+                index++;
+            }
+            if (index == view.len)
+            {
+                break;
+            }
+        }
+
+        uint32_t next = delta[row + multi->class_of[(unsigned char)view.str[index]]];
+        row = next & ~MULTI_MATCH_FLAG;
+        if (!(next & MULTI_MATCH_FLAG))
+        {
+            continue;
+        }
+
+        uint32_t state = (uint32_t)(row / class_num);
+
+        // every pattern ending here: those of this state, then those of its suffix states, longest first
+        for (uint32_t out = multi->first_id[state] != MULTI_NONE ? state : multi->out_link[state]; out != MULTI_NONE; out = multi->out_link[out])
+        {
+            for (uint32_t id = multi->first_id[out]; id != MULTI_NONE; id = multi->next_id[id])
+            {
+                match_num++;
+                if (callback && !callback(id, index + 1 - multi->pattern_len_arr[id], context))
+                {
+                    return match_num;
+                }
+            }
+        }
+    }
+
+    return match_num;
+}
+
+// appends one match to the strix_match_arr_t in context; stops the scan if it can't grow
+static bool multi_collect(size_t pattern_id, size_t pos, void *context)
+{
+    strix_match_arr_t *match_arr = (strix_match_arr_t *)context;
+    if (match_arr->len == match_arr->capacity)
+    {
+        size_t capacity = match_arr->capacity ? match_arr->capacity * 2 : 64;
+        strix_match_t *matches = (strix_match_t *)realloc(match_arr->match_arr, sizeof(strix_match_t) * capacity);
+        if (!matches)
+        {
+            strix_errno = STRIX_ERR_MALLOC_FAILED;
+            return false;
+        }
+        match_arr->match_arr = matches;
+        match_arr->capacity = capacity;
+    }
+
+    match_arr->match_arr[match_arr->len].pattern_id = pattern_id;
+    match_arr->match_arr[match_arr->len].pos = pos;
+    match_arr->len++;
+    return true;
+}
+
+strix_match_arr_t *strix_multi_pattern_find_all(const strix_multi_pattern_t *multi, strix_view_t view)
+{
+    strix_match_arr_t *match_arr = (strix_match_arr_t *)malloc(sizeof(strix_match_arr_t));
+    if (!match_arr)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+    match_arr->match_arr = NULL;
+    match_arr->len = 0;
+    match_arr->capacity = 0;
+
+    if (strix_multi_pattern_scan(multi, view, multi_collect, match_arr) == -1 || strix_errno == STRIX_ERR_MALLOC_FAILED)
+    {
+        strix_free_match_arr(match_arr);
+        return NULL;
+    }
+
+    return match_arr;
+}
+
+void strix_free_match_arr(strix_match_arr_t *match_arr)
+{
+    if (!match_arr)
+    {
+        return;
+    }
+
+    free(match_arr->match_arr);
+    free(match_arr);
+}
+
+#undef MULTI_NONE
+#undef MULTI_MATCH_FLAG
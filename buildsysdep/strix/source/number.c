@@ -0,0 +1,495 @@
+#include "../header/strix.h"
+#include "../allocator/allocator.h"
+
+#include <float.h>
+#include <math.h>
+#include <strings.h>
+
+#define NUMBER_MIN_POW10 (-342) // below 1e-342 every 19-digit mantissa rounds to 0
+#define NUMBER_MAX_POW10 308    // above 1e308 every nonzero mantissa is infinite
+#define NUMBER_MAX_DIGITS 19    // the most significant digits that always fit a uint64_t
+#define NUMBER_MANTISSA_BITS 52
+#define NUMBER_EXPONENT_BIAS 1023
+#define NUMBER_INFINITE_POWER 0x7FF
+#define NUMBER_FALLBACK_STACK_LEN 128
+
+#include "number_table.h"
+
+static inline bool number_is_digit(char chr)
+{
+    return (unsigned char)(chr - '0') < 10;
+}
+
+static inline uint64_t number_read64(const char *ptr)
+{
+    uint64_t value;
+    memcpy(&value, ptr, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+// whether all 8 bytes of a little-endian word are ASCII digits: each byte must have 3 in its high nibble,
+// and adding 6 must not carry into it
+static inline bool number_is_eight_digits(uint64_t word)
+{
+    return !(((word & 0xF0F0F0F0F0F0F0F0ULL) | (((word + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ^
+             0x3333333333333333ULL);
+}
+
+// the value of 8 ASCII digits in a little-endian word; neighbouring digits combine into pairs, the pairs into
+// quadruples and those into the result, in three multiplications
+static inline uint32_t number_parse_eight_digits(uint64_t word)
+{
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    word -= 0x3030303030303030ULL;
+    word = (word * 10) + (word >> 8);
+    return (uint32_t)((((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32);
+}
+
+// accumulates the digits at str[*index] onward into *value (wrapping if there are too many) and returns how many there were
+static size_t number_parse_digits(const char *str, size_t len, size_t *index, uint64_t *value)
+{
+    size_t start = *index;
+    uint64_t accumulated = *value;
+    while (*index + 8 <= len && number_is_eight_digits(number_read64(str + *index)))
+    {
+        accumulated = accumulated * 100000000 + number_parse_eight_digits(number_read64(str + *index));
+        *index += 8;
+    }
+    while (*index < len && number_is_digit(str[*index]))
+    {
+        accumulated = accumulated * 10 + (uint64_t)(str[*index] - '0');
+        (*index)++;
+    }
+
+    *value = accumulated;
+    return *index - start;
+}
+
+// parses the digits of an unsigned integer; the value fails to fit only if the digits go past 19, so they
+// are taken 8 at a time up to there and checked one by one after
+static size_t number_parse_magnitude(strix_view_t view, size_t index, uint64_t *value)
+{
+    size_t start = index;
+    uint64_t magnitude = 0;
+    while (index - start + 8 <= NUMBER_MAX_DIGITS && index + 8 <= view.len && number_is_eight_digits(number_read64(view.str + index)))
+    {
+        magnitude = magnitude * 100000000 + number_parse_eight_digits(number_read64(view.str + index));
+        index += 8;
+    }
+
+    for (; index < view.len && number_is_digit(view.str[index]); index++)
+    {
+        if (__builtin_mul_overflow(magnitude, 10, &magnitude) || __builtin_add_overflow(magnitude, (uint64_t)(view.str[index] - '0'), &magnitude))
+        {
+            strix_errno = STRIX_ERR_INT_OVERFLOW;
+            return 0;
+        }
+    }
+
+    if (index == start)
+    {
+        strix_errno = STRIX_ERR_INVALID_INT;
+        return 0;
+    }
+
+    *value = magnitude;
+    return index;
+}
+
+size_t strix_view_to_unsigned_int(strix_view_t view, uint64_t *value)
+{
+    if ((!view.str && view.len) || !value)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    size_t index = view.len && view.str[0] == '+';
+    return number_parse_magnitude(view, index, value);
+}
+
+size_t strix_view_to_signed_int(strix_view_t view, int64_t *value)
+{
+    if ((!view.str && view.len) || !value)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    bool is_neg = view.len && view.str[0] == '-';
+    size_t index = view.len && (is_neg || view.str[0] == '+');
+
+    uint64_t magnitude;
+    size_t consumed = number_parse_magnitude(view, index, &magnitude);
+    if (!consumed)
+    {
+        return 0;
+    }
+
+    // INT64_MIN has no positive counterpart
+    if (magnitude > (uint64_t)INT64_MAX + is_neg)
+    {
+        strix_errno = STRIX_ERR_INT_OVERFLOW;
+        return 0;
+    }
+
+    *value = is_neg ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return consumed;
+}
+
+typedef struct
+{
+    uint64_t mantissa; // at most NUMBER_MAX_DIGITS significant digits
+    int64_t exponent;  // the value is mantissa * 10^exponent
+    bool is_neg;
+    bool truncated; // digits past NUMBER_MAX_DIGITS were dropped, so the value lies between mantissa and mantissa + 1
+} number_decimal_t;
+
+// parses [+-]digits[.digits][(e|E)[+-]digits], where either the integer or the fraction digits may be missing;
+// returns the bytes consumed, 0 if there is no number
+static size_t number_parse_decimal(strix_view_t view, number_decimal_t *decimal)
+{
+    const char *str = view.str;
+    size_t len = view.len;
+    size_t index = 0;
+
+    decimal->is_neg = len && str[0] == '-';
+    index = len && (str[0] == '-' || str[0] == '+');
+
+    uint64_t mantissa = 0;
+    size_t integer_start = index;
+    size_t integer_num = number_parse_digits(str, len, &index, &mantissa);
+    size_t integer_end = index;
+
+    size_t fraction_start = index;
+    size_t fraction_num = 0;
+    if (index < len && str[index] == '.')
+    {
+        fraction_start = ++index;
+        fraction_num = number_parse_digits(str, len, &index, &mantissa);
+    }
+
+    if (!integer_num && !fraction_num)
+    {
+        return 0;
+    }
+
+    int64_t exponent = 0;
+    if (index < len && (str[index] == 'e' || str[index] == 'E'))
+    {
+        size_t exponent_index = index + 1;
+        bool exponent_neg = exponent_index < len && str[exponent_index] == '-';
+        exponent_index += exponent_index < len && (str[exponent_index] == '-' || str[exponent_index] == '+');
+
+        // an 'e' not followed by digits isn't part of the number
+        if (exponent_index < len && number_is_digit(str[exponent_index]))
+        {
+            for (; exponent_index < len && number_is_digit(str[exponent_index]); exponent_index++)
+            {
+                if (exponent < 0x10000000) // far past any finite nonzero double, and far from overflowing
+                {
+                    exponent = exponent * 10 + (str[exponent_index] - '0');
+                }
+            }
+            exponent = exponent_neg ? -exponent : exponent;
+            index = exponent_index;
+        }
+    }
+
+    decimal->truncated = false;
+    decimal->mantissa = mantissa;
+    decimal->exponent = exponent - (int64_t)fraction_num;
+
+    // only significant digits count against the limit, so leading zeros are discounted first
+    size_t digit_num = integer_num + fraction_num;
+    if (digit_num > NUMBER_MAX_DIGITS)
+    {
+        for (size_t pos = integer_start; pos < index && (str[pos] == '0' || str[pos] == '.'); pos++)
+        {
+            digit_num -= str[pos] == '0';
+        }
+    }
+
+    if (digit_num > NUMBER_MAX_DIGITS)
+    {
+        // keep the first 19 significant digits, scaling the exponent by the ones dropped
+        const uint64_t min_nineteen_digits = 1000000000000000000ULL;
+        decimal->truncated = true;
+        mantissa = 0;
+        size_t pos = integer_start;
+        for (; mantissa < min_nineteen_digits && pos < integer_end; pos++)
+        {
+            mantissa = mantissa * 10 + (uint64_t)(str[pos] - '0');
+        }
+
+        if (mantissa >= min_nineteen_digits)
+        {
+            decimal->exponent = exponent + (int64_t)(integer_end - pos);
+        }
+        else
+        {
+            for (pos = fraction_start; mantissa < min_nineteen_digits && pos < fraction_start + fraction_num; pos++)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(str[pos] - '0');
+            }
+            decimal->exponent = exponent - (int64_t)(pos - fraction_start);
+        }
+        decimal->mantissa = mantissa;
+    }
+
+    return index;
+}
+
+typedef struct
+{
+    uint64_t mantissa; // without the implicit bit
+    int32_t power2;    // biased; 0 for subnormals and zero, NUMBER_INFINITE_POWER for infinity, -1 if undecided
+} number_binary_t;
+
+static inline uint64_t number_mul_high(uint64_t lhs, uint64_t rhs, uint64_t *low)
+{
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)lhs * rhs;
+    *low = (uint64_t)product;
+    return (uint64_t)(product >> 64);
+#else
+    uint64_t lo_lo = (lhs & 0xffffffff) * (rhs & 0xffffffff);
+    uint64_t hi_lo = (lhs >> 32) * (rhs & 0xffffffff);
+    uint64_t lo_hi = (lhs & 0xffffffff) * (rhs >> 32);
+    uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    *low = (cross << 32) | (lo_lo & 0xffffffff);
+    return (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif
+}
+
+// Eisel-Lemire: the binary double nearest mantissa * 10^exponent, from a 128-bit approximation of 5^exponent.
+// The truncated product is always close enough to round 19-digit mantissas correctly, so the answer is only
+// ever undecided for decimals that had to be truncated (which compare mantissa and mantissa + 1 instead)
+static number_binary_t number_eisel_lemire(uint64_t mantissa, int64_t exponent)
+{
+    number_binary_t binary = {0, 0};
+    if (!mantissa || exponent < NUMBER_MIN_POW10)
+    {
+        return binary;
+    }
+    if (exponent > NUMBER_MAX_POW10)
+    {
+        binary.power2 = NUMBER_INFINITE_POWER;
+        return binary;
+    }
+
+    int leading_zeros = __builtin_clzll(mantissa);
+    mantissa <<= leading_zeros;
+
+    // the first 64 bits of the product decide the 55 bits we keep, unless they end in a run of ones that a carry
+    // from the low half could still flip
+    size_t entry = 2 * (size_t)(exponent - NUMBER_MIN_POW10);
+    uint64_t low;
+    uint64_t high = number_mul_high(mantissa, number_pow5_128[entry], &low);
+    const uint64_t precision_mask = UINT64_MAX >> (NUMBER_MANTISSA_BITS + 3);
+    if ((high & precision_mask) == precision_mask)
+    {
+        uint64_t second_low;
+        uint64_t second_high = number_mul_high(mantissa, number_pow5_128[entry + 1], &second_low);
+        low += second_high;
+        high += second_high > low;
+    }
+
+    int upper_bit = (int)(high >> 63);
+    int shift = upper_bit + 64 - NUMBER_MANTISSA_BITS - 3;
+    binary.mantissa = high >> shift;
+
+    // floor(log2(10^exponent)) + 63, computed exactly for every exponent in range
+    int32_t power2 = (int32_t)((((152170 + 65536) * exponent) >> 16) + 63);
+    binary.power2 = power2 + upper_bit - leading_zeros + NUMBER_EXPONENT_BIAS;
+
+    if (binary.power2 <= 0)
+    {
+        // subnormal: shift out the bits below the smallest exponent, then round to nearest
+        if (-binary.power2 + 1 >= 64)
+        {
+            binary.mantissa = 0;
+            binary.power2 = 0;
+            return binary;
+        }
+        binary.mantissa >>= -binary.power2 + 1;
+        binary.mantissa += binary.mantissa & 1;
+        binary.mantissa >>= 1;
+        // rounding up may have made it the smallest normal number
+        binary.power2 = binary.mantissa < (1ULL << NUMBER_MANTISSA_BITS) ? 0 : 1;
+        binary.mantissa &= ~(1ULL << NUMBER_MANTISSA_BITS);
+        return binary;
+    }
+
+    // an exact halfway case (possible only for small exponents) rounds to even rather than up
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (binary.mantissa & 3) == 1 && (binary.mantissa << shift) == high)
+    {
+        binary.mantissa &= ~1ULL;
+    }
+
+    binary.mantissa += binary.mantissa & 1;
+    binary.mantissa >>= 1;
+    if (binary.mantissa >= (2ULL << NUMBER_MANTISSA_BITS))
+    {
+        binary.mantissa = 1ULL << NUMBER_MANTISSA_BITS;
+        binary.power2++;
+    }
+    binary.mantissa &= ~(1ULL << NUMBER_MANTISSA_BITS);
+
+    if (binary.power2 >= NUMBER_INFINITE_POWER)
+    {
+        binary.mantissa = 0;
+        binary.power2 = NUMBER_INFINITE_POWER;
+    }
+    return binary;
+}
+
+static double number_to_double(number_binary_t binary, bool is_neg)
+{
+    uint64_t bits = binary.mantissa | ((uint64_t)binary.power2 << NUMBER_MANTISSA_BITS) | ((uint64_t)is_neg << 63);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// exact powers of ten; a double holds every one up to 1e22
+static const double number_pow10_exact[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// for the rare decimal that Eisel-Lemire leaves undecided
+static bool number_strtod(const char *str, size_t len, double *value)
+{
+    char stack_buffer[NUMBER_FALLBACK_STACK_LEN];
+    char *buffer = stack_buffer;
+    if (len >= sizeof(stack_buffer))
+    {
+        buffer = (char *)allocate(len + 1);
+        if (!buffer)
+        {
+            strix_errno = STRIX_ERR_MALLOC_FAILED;
+            return false;
+        }
+    }
+
+    memcpy(buffer, str, len);
+    buffer[len] = 0;
+    *value = strtod(buffer, NULL);
+
+    if (buffer != stack_buffer)
+    {
+        deallocate(buffer);
+    }
+    return true;
+}
+
+// "inf", "infinity" and "nan" in any case, as strtod reads them
+static size_t number_parse_special(strix_view_t view, double *value)
+{
+    size_t index = view.len && (view.str[0] == '-' || view.str[0] == '+');
+    bool is_neg = view.len && view.str[0] == '-';
+    size_t rest = view.len - index;
+    const char *str = view.str + index;
+
+    if (rest >= 3 && !strncasecmp(str, "nan", 3))
+    {
+        *value = is_neg ? -NAN : NAN;
+
+        // strtod also takes a parenthesized payload
+        size_t end = 3;
+        if (end < rest && str[end] == '(')
+        {
+            for (end++; end < rest && (isalnum((unsigned char)str[end]) || str[end] == '_'); end++)
+            {
+            }
+            if (end < rest && str[end] == ')')
+            {
+                return index + end + 1;
+            }
+        }
+        return index + 3;
+    }
+
+    if (rest >= 3 && !strncasecmp(str, "inf", 3))
+    {
+        *value = is_neg ? -INFINITY : INFINITY;
+        return index + (rest >= 8 && !strncasecmp(str, "infinity", 8) ? 8 : 3);
+    }
+
+    return 0;
+}
+
+size_t strix_view_to_double(strix_view_t view, double *value)
+{
+    if ((!view.str && view.len) || !value)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return 0;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+
+    number_decimal_t decimal;
+    size_t consumed = number_parse_decimal(view, &decimal);
+    if (!consumed)
+    {
+        consumed = number_parse_special(view, value);
+        if (!consumed)
+        {
+            strix_errno = STRIX_ERR_INVALID_DOUBLE;
+        }
+        return consumed;
+    }
+
+    // Clinger's fast path: both factors are exact doubles, so one correctly rounded operation gives the answer
+    // (as long as the operation isn't carried out in extended precision and rounded twice)
+    if (FLT_EVAL_METHOD == 0 && !decimal.truncated && decimal.mantissa <= (1ULL << 53) && decimal.exponent >= -22 && decimal.exponent <= 22)
+    {
+        double result = (double)decimal.mantissa;
+        if (decimal.exponent < 0)
+        {
+            result /= number_pow10_exact[-decimal.exponent];
+        }
+        else
+        {
+            result *= number_pow10_exact[decimal.exponent];
+        }
+        *value = decimal.is_neg ? -result : result;
+        return consumed;
+    }
+
+    number_binary_t binary = number_eisel_lemire(decimal.mantissa, decimal.exponent);
+    if (decimal.truncated)
+    {
+        number_binary_t above = number_eisel_lemire(decimal.mantissa + 1, decimal.exponent);
+        if (above.mantissa != binary.mantissa || above.power2 != binary.power2)
+        {
+            binary.power2 = -1;
+        }
+    }
+
+    if (binary.power2 < 0)
+    {
+        return number_strtod(view.str, consumed, value) ? consumed : 0;
+    }
+
+    *value = number_to_double(binary, decimal.is_neg);
+    return consumed;
+}
+
+#undef NUMBER_MIN_POW10
+#undef NUMBER_MAX_POW10
+#undef NUMBER_MAX_DIGITS
+#undef NUMBER_MANTISSA_BITS
+#undef NUMBER_EXPONENT_BIAS
+#undef NUMBER_INFINITE_POWER
+#undef NUMBER_FALLBACK_STACK_LEN
@@ -1,154 +1,244 @@
 #include "../header/string_search.h"
 
-int64_t kmp_search(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
-{
-    size_t lps[pattern_len];
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define STRING_SEARCH_X86
+#endif
+
+#include <stdatomic.h>
+
+#define SEARCH_NOT_FOUND SIZE_MAX
+
+// patterns longer than this are searched with Horspool, whose skips grow with the pattern;
+// shorter ones go through the first-and-last-byte vector filter
+#define SHORT_PATTERN_LEN 32
 
-    size_t i = 1, j = 0;
-    lps[0] = 0;
+typedef size_t (*short_search_t)(const char *string, size_t string_len, const char *pattern, size_t pattern_len, size_t from);
 
-    while (i < pattern_len)
+// memchr finds each candidate first byte, then the rest of the pattern is compared; also finishes the vector loops
+static size_t search_scalar(const char *string, size_t string_len, const char *pattern, size_t pattern_len, size_t from)
+{
+    if (string_len < pattern_len)
     {
-        if (pattern[i] == pattern[j])
+        return SEARCH_NOT_FOUND;
+    }
+
+    const char *cursor = string + from;
+    const char *last = string + (string_len - pattern_len);
+    while (cursor <= last)
+    {
+        cursor = (const char *)memchr(cursor, pattern[0], (size_t)(last - cursor) + 1);
+        if (!cursor)
         {
-            j++;
-            lps[i] = j;
-            i++;
+            return SEARCH_NOT_FOUND;
         }
-        else
+
+        if (!memcmp(cursor + 1, pattern + 1, pattern_len - 1))
         {
-            if (j != 0)
-            {
-                j = lps[j - 1];
-            }
-            else
-            {
-                lps[i] = 0;
-                i++;
-            }
+            return (size_t)(cursor - string);
         }
+        cursor++;
     }
 
-    i = 0;
-    j = 0;
+    return SEARCH_NOT_FOUND;
+}
 
-    while (i < string_len)
+static size_t search_horspool(const size_t *skip, const char *string, size_t string_len, const char *pattern, size_t pattern_len, size_t from)
+{
+    unsigned char last = (unsigned char)pattern[pattern_len - 1];
+
+    for (size_t pos = from; pos + pattern_len <= string_len;)
     {
-        if (pattern[j] == string[i])
+        unsigned char chr = (unsigned char)string[pos + pattern_len - 1];
+        if (chr == last && !memcmp(string + pos, pattern, pattern_len - 1))
         {
-            j++;
-            i++;
+            return pos;
+        }
+        pos += skip[chr];
+    }
 
-            if (j == pattern_len)
+    return SEARCH_NOT_FOUND;
+}
+
+#ifdef STRING_SEARCH_X86
+
+// each vector compares the first pattern byte against 16 (or 32) candidate positions and the last pattern
+// byte against the positions pattern_len - 1 further on; only positions matching both are compared in full
+static size_t search_sse2(const char *string, size_t string_len, const char *pattern, size_t pattern_len, size_t from)
+{
+    const __m128i first = _mm_set1_epi8(pattern[0]);
+    const __m128i last = _mm_set1_epi8(pattern[pattern_len - 1]);
+
+    size_t pos = from;
+    for (; pos + 16 + pattern_len - 1 <= string_len; pos += 16)
+    {
+        __m128i block_first = _mm_loadu_si128((const __m128i *)(string + pos));
+        __m128i block_last = _mm_loadu_si128((const __m128i *)(string + pos + pattern_len - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        while (mask)
+        {
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (!memcmp(string + pos + bit + 1, pattern + 1, pattern_len - 2))
             {
-                j = lps[j - 1]; // the search can be continued using this, but i return after finding the first match
-                return (i - j - 1);
+                return pos + bit;
             }
+            mask &= mask - 1;
         }
-        else
+    }
+
+    return search_scalar(string, string_len, pattern, pattern_len, pos);
+}
+
+__attribute__((target("avx2"))) static size_t search_avx2(const char *string, size_t string_len, const char *pattern, size_t pattern_len, size_t from)
+{
+    const __m256i first = _mm256_set1_epi8(pattern[0]);
+    const __m256i last = _mm256_set1_epi8(pattern[pattern_len - 1]);
+
+    size_t pos = from;
+    for (; pos + 32 + pattern_len - 1 <= string_len; pos += 32)
+    {
+        __m256i block_first = _mm256_loadu_si256((const __m256i *)(string + pos));
+        __m256i block_last = _mm256_loadu_si256((const __m256i *)(string + pos + pattern_len - 1));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        while (mask)
         {
-            if (j > 0)
+            unsigned bit = (unsigned)__builtin_ctz(mask);
+            if (!memcmp(string + pos + bit + 1, pattern + 1, pattern_len - 2))
             {
-                j = lps[j - 1];
-            }
-            else
-            {
-                i++;
+                return pos + bit;
             }
+            mask &= mask - 1;
         }
     }
 
-    return -2;
+    return search_sse2(string, string_len, pattern, pattern_len, pos);
 }
 
-int64_t kmp_search_all_len(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+// picks the widest vector search the CPU supports, probing it only once
+static short_search_t search_select(void)
 {
-    size_t lps[pattern_len];
-    int64_t counter = 0;
+    static _Atomic(short_search_t) selected = NULL;
 
-    size_t i = 1, j = 0;
-    lps[0] = 0;
+    short_search_t search = atomic_load_explicit(&selected, memory_order_relaxed);
+    if (!search)
+    {
+        __builtin_cpu_init();
+        search = __builtin_cpu_supports("avx2") ? search_avx2 : search_sse2;
+        atomic_store_explicit(&selected, search, memory_order_relaxed); // racing first calls store the same value
+    }
+
+    return search;
+}
+
+#else
+
+static short_search_t search_select(void)
+{
+    return search_scalar;
+}
+
+#endif
 
-    while (i < pattern_len)
+// everything a search needs that depends only on the pattern; read-only once initialized
+typedef struct
+{
+    const char *pattern;
+    size_t pattern_len;
+    short_search_t short_search; // vector search for patterns of 2 to SHORT_PATTERN_LEN bytes
+    size_t skip[256];            // Horspool shift per byte, only filled for longer patterns
+} search_plan_t;
+
+static void search_plan_init(search_plan_t *plan, const char *pattern, size_t pattern_len)
+{
+    plan->pattern = pattern;
+    plan->pattern_len = pattern_len;
+    plan->short_search = search_select();
+
+    if (pattern_len > SHORT_PATTERN_LEN)
     {
-        if (pattern[i] == pattern[j])
+        for (size_t index = 0; index < 256; index++)
         {
-            j++;
-            lps[i] = j;
-            i++;
+            plan->skip[index] = pattern_len;
         }
-        else
+        for (size_t index = 0; index + 1 < pattern_len; index++)
         {
-            if (j != 0)
-            {
-                j = lps[j - 1];
-            }
-            else
-            {
-                lps[i] = 0;
-                i++;
-            }
+            plan->skip[(unsigned char)pattern[index]] = pattern_len - 1 - index;
         }
     }
+}
 
-    i = 0;
-    j = 0;
+// finds the first match of the plan's pattern at or after from
+static size_t search_plan_find(const search_plan_t *plan, const char *string, size_t string_len, size_t from)
+{
+    size_t pattern_len = plan->pattern_len;
+    if (from > string_len || string_len - from < pattern_len)
+    {
+        return SEARCH_NOT_FOUND;
+    }
 
-    while (i < string_len)
+    if (pattern_len == 0)
     {
-        if (pattern[j] == string[i])
-        {
-            j++;
-            i++;
+        return from;
+    }
 
-            if (j == pattern_len)
-            {
-                j = lps[j - 1];
-                counter++;
-            }
-        }
-        else
-        {
-            if (j > 0)
-            {
-                j = lps[j - 1];
-            }
-            else
-            {
-                i++;
-            }
-        }
+    if (pattern_len == 1)
+    {
+        const char *found = (const char *)memchr(string + from, plan->pattern[0], string_len - from);
+        return found ? (size_t)(found - string) : SEARCH_NOT_FOUND;
     }
 
-    return counter;
+    if (pattern_len > SHORT_PATTERN_LEN)
+    {
+        return search_horspool(plan->skip, string, string_len, plan->pattern, pattern_len, from);
+    }
+
+    return plan->short_search(string, string_len, plan->pattern, pattern_len, from);
 }
 
-position_t *kmp_search_all(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+int64_t string_search(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
 {
-    if (!pattern || !string || pattern_len == 0 || pattern_len > string_len)
+    if ((!pattern && pattern_len) || (!string && string_len))
     {
         strix_errno = STRIX_ERR_NULL_PTR;
-        return NULL;
+        return -1;
     }
 
-    position_t *position = (position_t *)malloc(sizeof(position_t));
-    if (!position)
+    search_plan_t plan;
+    search_plan_init(&plan, pattern, pattern_len);
+
+    size_t found = search_plan_find(&plan, string, string_len, 0);
+    return found == SEARCH_NOT_FOUND ? -2 : (int64_t)found;
+}
+
+// counts the (possibly overlapping) matches of the plan's pattern
+static int64_t search_plan_count(const search_plan_t *plan, const char *string, size_t string_len)
+{
+    if (!plan->pattern_len)
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
+        return 0;
     }
-    position->pos = NULL;
-    position->len = 0;
 
-    size_t *lps = (size_t *)malloc(sizeof(size_t) * pattern_len);
-    if (!lps)
+    // matches may overlap, so each search resumes one past the previous match
+    int64_t counter = 0;
+    for (size_t found = search_plan_find(plan, string, string_len, 0); found != SEARCH_NOT_FOUND; found = search_plan_find(plan, string, string_len, found + 1))
+    {
+        counter++;
+    }
+
+    return counter;
+}
+
+// collects the (possibly overlapping) matches of the plan's pattern; len is -2 if there are none
+static position_t *search_plan_find_all(const search_plan_t *plan, const char *string, size_t string_len)
+{
+    position_t *position = (position_t *)malloc(sizeof(position_t));
+    if (!position)
     {
-        free(position);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
 
-    size_t current_max_positions = (string_len / pattern_len) + 1;
+    size_t current_max_positions = plan->pattern_len ? (string_len / plan->pattern_len) + 1 : 1;
     if (current_max_positions > MAX_POSITIONS)
     {
         current_max_positions = MAX_POSITIONS;
@@ -157,88 +247,33 @@ position_t *kmp_search_all(const char *pattern, const char *string, size_t patte
     size_t *pos_arr = (size_t *)malloc(sizeof(size_t) * current_max_positions);
     if (!pos_arr)
     {
-        free(lps);
         free(position);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
 
-    size_t i = 1, j = 0;
-    lps[0] = 0;
-    while (i < pattern_len)
+    size_t counter = 0;
+    size_t found = plan->pattern_len ? search_plan_find(plan, string, string_len, 0) : SEARCH_NOT_FOUND;
+    for (; found != SEARCH_NOT_FOUND; found = search_plan_find(plan, string, string_len, found + 1))
     {
-        if (pattern[i] == pattern[j])
+        if (counter >= current_max_positions)
         {
-            j++;
-            lps[i] = j;
-            i++;
-        }
-        else
-        {
-            if (j != 0)
-            {
-                j = lps[j - 1];
-            }
-            else
+            size_t new_size = current_max_positions * 2;
+            size_t *new_pos_arr = (size_t *)realloc(pos_arr, sizeof(size_t) * new_size);
+            if (!new_pos_arr)
             {
-                lps[i] = 0;
-                i++;
+                free(pos_arr);
+                free(position);
+                strix_errno = STRIX_ERR_MALLOC_FAILED;
+                return NULL;
             }
+            pos_arr = new_pos_arr;
+            current_max_positions = new_size;
         }
-    }
-
-    i = 0;
-    j = 0;
-    int64_t counter = 0;
 
-    while (i < string_len)
-    {
-        if (pattern[j] == string[i])
-        {
-            j++;
-            i++;
-            if (j == pattern_len)
-            {
-                if (counter >= current_max_positions)
-                {
-                    size_t new_size = current_max_positions * 2;
-                    if (new_size < current_max_positions)
-                    {
-                        new_size = SIZE_MAX / sizeof(size_t);
-                    }
-
-                    size_t *new_pos_arr = (size_t *)realloc(pos_arr, sizeof(size_t) * new_size);
-                    if (!new_pos_arr)
-                    {
-                        free(pos_arr);
-                        free(lps);
-                        free(position);
-                        strix_errno = STRIX_ERR_MALLOC_FAILED;
-                        return NULL;
-                    }
-                    pos_arr = new_pos_arr;
-                    current_max_positions = new_size;
-                }
-
-                pos_arr[counter++] = i - pattern_len;
-                j = lps[j - 1];
-            }
-        }
-        else
-        {
-            if (j > 0)
-            {
-                j = lps[j - 1];
-            }
-            else
-            {
-                i++;
-            }
-        }
+        pos_arr[counter++] = found;
     }
 
-    free(lps);
-
     if (counter == 0)
     {
         free(pos_arr);
@@ -256,7 +291,50 @@ position_t *kmp_search_all(const char *pattern, const char *string, size_t patte
         }
     }
 
-    position->len = counter;
+    position->len = (int64_t)counter;
     position->pos = pos_arr;
     return position;
-}
\ No newline at end of file
+}
+
+int64_t string_search_all_len(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+{
+    if ((!pattern && pattern_len) || (!string && string_len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    search_plan_t plan;
+    search_plan_init(&plan, pattern, pattern_len);
+    return search_plan_count(&plan, string, string_len);
+}
+
+position_t *string_search_all(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+{
+    if (!pattern || !string || pattern_len == 0 || pattern_len > string_len)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return NULL;
+    }
+
+    search_plan_t plan;
+    search_plan_init(&plan, pattern, pattern_len);
+    return search_plan_find_all(&plan, string, string_len);
+}
+
+int64_t kmp_search(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+{
+    return string_search(pattern, string, pattern_len, string_len);
+}
+
+position_t *kmp_search_all(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+{
+    return string_search_all(pattern, string, pattern_len, string_len);
+}
+
+int64_t kmp_search_all_len(const char *pattern, const char *string, size_t pattern_len, size_t string_len)
+{
+    return string_search_all_len(pattern, string, pattern_len, string_len);
+}
+
+#undef SHORT_PATTERN_LEN
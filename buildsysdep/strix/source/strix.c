@@ -1,5 +1,11 @@
 #include <threads.h>
 #include <stdint.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "../header/strix.h"
 #include "../allocator/allocator.h"
@@ -26,7 +32,7 @@ static inline bool is_str_null(const char *str)
 
 static inline bool is_strix_str_null(const strix_t *strix)
 {
-    if (!strix->str)
+    if (!strix_str(strix))
     {
         strix_errno = STRIX_ERR_NULL_PTR;
         return true;
@@ -36,7 +42,7 @@ static inline bool is_strix_str_null(const strix_t *strix)
 
 static inline bool is_strix_empty(const strix_t *strix)
 {
-    if (!strix->len)
+    if (!strix_len(strix))
     {
         strix_errno = STRIX_ERR_EMPTY_STRING;
         return true;
@@ -49,25 +55,184 @@ static inline bool is_strix_empty_or_null(const strix_t *strix)
     return is_strix_null(strix) || is_strix_empty(strix);
 }
 
-strix_t *strix_create_empty()
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define STRIX_CAPACITY_SHIFT 8 // the tag byte is the lowest byte of heap.capacity, so the capacity is kept above it
+#else
+#define STRIX_CAPACITY_SHIFT 0 // the tag byte is the highest byte of heap.capacity, whose top bit no capacity reaches
+#endif
+#define STRIX_CAPACITY_MAX (SIZE_MAX >> (STRIX_CAPACITY_SHIFT ? STRIX_CAPACITY_SHIFT : 1))
+
+_Static_assert(sizeof(strix_t) == sizeof(char *) + 2 * sizeof(size_t), "the inline string must overlay the heap fields exactly");
+
+static inline bool strix_is_inline(const strix_t *strix)
 {
-    char *str = allocate(0);
-    if (!str)
+    return strix->local.tag & STRIX_INLINE_TAG;
+}
+
+static inline size_t strix_capacity(const strix_t *strix)
+{
+    return strix_is_inline(strix) ? STRIX_INLINE_LEN : strix->heap.capacity >> STRIX_CAPACITY_SHIFT;
+}
+
+// sets the length of strix, which its storage must already fit
+static inline void strix_set_len(strix_t *strix, size_t len)
+{
+    if (strix_is_inline(strix))
+    {
+        strix->local.tag = (unsigned char)(STRIX_INLINE_TAG | len);
+    }
+    else
     {
+        strix->heap.len = len;
+    }
+}
+
+// points strix at a heap buffer of capacity bytes (at most STRIX_CAPACITY_MAX), len of which are used
+static inline void strix_set_heap(strix_t *strix, char *str, size_t len, size_t capacity)
+{
+    strix->heap.str = str;
+    strix->heap.len = len;
+    strix->heap.capacity = capacity << STRIX_CAPACITY_SHIFT;
+}
+
+// frees the buffer of strix unless it is stored inline
+static void strix_release(strix_t *strix)
+{
+    if (!strix_is_inline(strix) && strix->heap.str)
+    {
+        deallocate(strix->heap.str);
+    }
+}
+
+// allocates a strix_t with room for len bytes; its len is set, its contents are left to the caller
+static strix_t *strix_new(size_t len)
+{
+    if (len > STRIX_CAPACITY_MAX)
+    {
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
         return NULL;
     }
 
     strix_t *strix = (strix_t *)allocate(sizeof(strix_t));
     if (!strix)
     {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+
+    // short strings live in the struct itself, sparing them a second allocation
+    if (len <= STRIX_INLINE_LEN)
+    {
+        strix->local.tag = (unsigned char)(STRIX_INLINE_TAG | len);
+        return strix;
+    }
+
+    char *str = (char *)allocate(sizeof(char) * len);
+    if (!str)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        deallocate(strix);
         return NULL;
     }
 
-    strix->str = str;
-    strix->len = 0;
+    strix_set_heap(strix, str, len, len);
     return strix;
 }
 
+// moves the contents of strix into a buffer of capacity bytes (at least its length), the inline one if it is large enough
+static bool strix_reallocate(strix_t *strix, size_t capacity)
+{
+    size_t len = strix_len(strix);
+    if (capacity <= STRIX_INLINE_LEN)
+    {
+        if (!strix_is_inline(strix))
+        {
+            // the inline characters overlay the heap fields, so the buffer is remembered before being copied over them
+            char *heap_str = strix->heap.str;
+            if (len)
+            {
+                memcpy(strix->local.str, heap_str, len);
+            }
+            strix->local.tag = (unsigned char)(STRIX_INLINE_TAG | len);
+            if (heap_str)
+            {
+                deallocate(heap_str);
+            }
+        }
+        return true;
+    }
+
+    if (capacity > STRIX_CAPACITY_MAX)
+    {
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
+        return false;
+    }
+
+    char *new_str = (char *)allocate(sizeof(char) * capacity);
+    if (!new_str)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return false;
+    }
+
+    if (len)
+    {
+        memcpy(new_str, strix_str(strix), len);
+    }
+    strix_release(strix);
+    strix_set_heap(strix, new_str, len, capacity);
+    return true;
+}
+
+// makes room for at least needed bytes, at least doubling the buffer so that a run of appends copies each byte O(1) times
+static bool strix_grow(strix_t *strix, size_t needed)
+{
+    size_t current = strix_capacity(strix);
+    if (needed <= current)
+    {
+        return true;
+    }
+
+    size_t capacity = current > SIZE_MAX / 2 ? SIZE_MAX : current * 2;
+    if (capacity < needed)
+    {
+        capacity = needed;
+    }
+
+    return strix_reallocate(strix, capacity);
+}
+
+// opens a gap of gap_len bytes at pos, growing strix if needed; the gap is left for the caller to fill
+static bool strix_open_gap(strix_t *strix, size_t pos, size_t gap_len)
+{
+    if (!gap_len)
+    {
+        return true;
+    }
+
+    size_t len = strix_len(strix);
+    if (gap_len > SIZE_MAX - len)
+    {
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
+        return false;
+    }
+
+    if (!strix_grow(strix, len + gap_len))
+    {
+        return false;
+    }
+
+    char *str = strix_str(strix);
+    memmove(str + pos + gap_len, str + pos, len - pos);
+    strix_set_len(strix, len + gap_len);
+    return true;
+}
+
+strix_t *strix_create_empty()
+{
+    return strix_new(0);
+}
+
 char *strix_to_cstr(strix_t *strix)
 {
     if (!strix)
@@ -75,15 +240,15 @@ char *strix_to_cstr(strix_t *strix)
         return NULL;
     }
 
-    char *str = malloc(sizeof(char) * (strix->len + 1)); // + 1 for null byte
+    char *str = malloc(sizeof(char) * (strix_len(strix) + 1)); // + 1 for null byte
     if (!str)
     {
         return NULL;
     }
 
-    memcpy(str, strix->str, strix->len);
+    memcpy(str, strix_str(strix), strix_len(strix));
 
-    str[strix->len] = 0; // append null byte
+    str[strix_len(strix)] = 0; // append null byte
     return str;
 }
 
@@ -96,37 +261,20 @@ strix_t *strix_create(const char *str)
         return NULL;
     }
 
-    strix_t *strix = (strix_t *)allocate(sizeof(strix_t));
-    if (!strix)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    strix->len = strlen(str);
-    if (!strix->len)
+    size_t len = strlen(str);
+    if (!len)
     {
         strix_errno = STRIX_ERR_EMPTY_STRING;
-        deallocate(strix);
         return NULL;
     }
 
-    strix->str = (char *)allocate(strix->len);
-    if (!strix->str)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        deallocate(strix);
-        return NULL;
-    }
-
-    if (!memmove(strix->str, str, strix->len))
+    strix_t *strix = strix_new(len);
+    if (!strix)
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
-        deallocate(strix->str);
-        deallocate(strix);
         return NULL;
     }
 
+    memcpy(strix_str(strix), str, len);
     return strix;
 }
 
@@ -139,30 +287,13 @@ strix_t *strix_duplicate(const strix_t *strix)
         return NULL;
     }
 
-    strix_t *duplicate = (strix_t *)allocate(sizeof(strix_t));
+    strix_t *duplicate = strix_new(strix_len(strix));
     if (!duplicate)
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    duplicate->len = strix->len;
-    duplicate->str = (char *)allocate(sizeof(char) * duplicate->len);
-    if (!duplicate->str)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        deallocate(duplicate);
-        return NULL;
-    }
-
-    if (!memcpy(duplicate->str, strix->str, strix->len))
-    {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        deallocate(duplicate->str);
-        deallocate(duplicate);
         return NULL;
     }
 
+    memcpy(strix_str(duplicate), strix_str(strix), strix_len(strix));
     return duplicate;
 }
 
@@ -188,8 +319,7 @@ void strix_free(strix_t *strix)
 {
     if (!strix)
         return;
-    if (strix->str)
-        deallocate(strix->str);
+    strix_release(strix);
     deallocate(strix);
 }
 
@@ -202,52 +332,69 @@ bool strix_clear(strix_t *strix)
         return false;
     }
 
-    strix->len = 0;
-    deallocate(strix->str);
-    strix->str = NULL;
+    strix_release(strix);
+    strix_set_heap(strix, NULL, 0, 0);
     return true;
 }
 
-bool strix_concat(strix_t *dest, const strix_t *src)
+bool strix_reserve(strix_t *strix, size_t capacity)
 {
     strix_errno = STRIX_SUCCESS;
 
-    if (is_strix_null(dest))
+    if (is_strix_null(strix))
     {
         return false;
     }
 
-    if (is_strix_null(src))
+    if (capacity <= strix_capacity(strix))
     {
-        return true; // nothing to concatenate, not an error
+        return true;
     }
 
-    size_t new_len = dest->len + src->len;
-    char *new_str = (char *)allocate(sizeof(char) * new_len);
-    if (!new_str)
+    return strix_reallocate(strix, capacity > strix_len(strix) ? capacity : strix_len(strix));
+}
+
+bool strix_shrink_to_fit(strix_t *strix)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_strix_null(strix))
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return false;
     }
 
-    if (!memcpy(new_str, dest->str, dest->len))
+    // an empty buffer is kept rather than freed, as the strix may be appended to again
+    size_t len = strix_len(strix);
+    if (!strix_str(strix) || strix_capacity(strix) == len || !len)
     {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        deallocate(new_str);
-        return false;
+        return true;
     }
 
-    if (!memcpy(new_str + dest->len, src->str, src->len))
+    return strix_reallocate(strix, len);
+}
+
+bool strix_concat(strix_t *dest, const strix_t *src)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_strix_null(dest))
     {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        deallocate(new_str);
         return false;
     }
 
-    deallocate(dest->str);
-    dest->str = new_str;
-    dest->len = new_len;
+    if (is_strix_null(src))
+    {
+        return true; // nothing to concatenate, not an error
+    }
+
+    // src may be dest itself, whose buffer growing would move
+    size_t src_len = strix_len(src);
+    if (!strix_open_gap(dest, strix_len(dest), src_len))
+    {
+        return false;
+    }
 
+    memcpy(strix_str(dest) + strix_len(dest) - src_len, strix_str(src), src_len);
     return true;
 }
 
@@ -266,83 +413,248 @@ bool strix_append(strix_t *strix, const char *str)
         return true; // nothing to append, not an error
     }
 
-    size_t new_len = strix->len + str_len;
-    char *new_str = (char *)allocate(sizeof(char) * new_len);
-    if (!new_str)
+    size_t len = strix_len(strix);
+    if (!strix_grow(strix, len + str_len))
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return false;
     }
 
-    if (!memcpy(new_str, strix->str, strix->len))
+    memcpy(strix_str(strix) + len, str, str_len);
+    strix_set_len(strix, len + str_len);
+    return true;
+}
+
+// appends len bytes, leaving room for the terminator strix_vappendf adds
+static bool strix_append_bytes(strix_t *strix, const char *bytes, size_t len)
+{
+    size_t strix_length = strix_len(strix);
+    if (len >= SIZE_MAX - strix_length)
     {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        deallocate(new_str);
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
         return false;
     }
 
-    if (!memcpy(new_str + strix->len, str, str_len))
+    if (!strix_grow(strix, strix_length + len + 1))
     {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        deallocate(new_str);
         return false;
     }
 
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len = new_len;
-
+    memcpy(strix_str(strix) + strix_length, bytes, len);
+    strix_set_len(strix, strix_length + len);
     return true;
 }
 
-bool strix_insert_str(strix_t *strix, size_t pos, const char *substr)
+// writes value in base 10 right before end, which needs 21 bytes for any 64-bit value and a sign; returns its start
+static char *format_decimal(char *end, uint64_t value, bool negative)
 {
-    if (is_strix_null(strix) || is_str_null(substr))
+    char *cursor = end;
+    do
     {
-        strix_errno = STRIX_ERR_NULL_PTR;
+        *--cursor = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    if (negative)
+    {
+        *--cursor = '-';
+    }
+
+    return cursor;
+}
+
+// reads the argument of a %d, %i or %u conversion with no length modifier or l, ll (given as 'L') or z
+static uint64_t next_integer(va_list *args, char modifier, bool is_signed, bool *negative)
+{
+    int64_t value;
+    switch (modifier)
+    {
+    case 'L':
+        value = is_signed ? (int64_t)va_arg(*args, long long) : (int64_t)va_arg(*args, unsigned long long);
+        break;
+    case 'l':
+        value = is_signed ? (int64_t)va_arg(*args, long) : (int64_t)va_arg(*args, unsigned long);
+        break;
+    case 'z':
+        value = is_signed ? (int64_t)va_arg(*args, ssize_t) : (int64_t)va_arg(*args, size_t);
+        break;
+    default:
+        value = is_signed ? (int64_t)va_arg(*args, int) : (int64_t)va_arg(*args, unsigned);
+        break;
+    }
+
+    *negative = is_signed && value < 0;
+    return *negative ? -(uint64_t)value : (uint64_t)value;
+}
+
+// formats straight into the spare capacity, growing exactly once if the result doesn't fit
+static bool strix_append_vsnprintf(strix_t *strix, const char *format, va_list args)
+{
+    va_list retry;
+    va_copy(retry, args);
+
+    size_t strix_length = strix_len(strix);
+    size_t spare = strix_str(strix) ? strix_capacity(strix) - strix_length : 0;
+    int len = vsnprintf(spare ? strix_str(strix) + strix_length : NULL, spare, format, args);
+    if (len < 0)
+    {
+        va_end(retry);
+        strix_errno = STRIX_ERR_STDIO;
         return false;
     }
 
-    if (is_strix_str_null(strix))
+    if ((size_t)len >= spare)
+    {
+        if (!strix_grow(strix, strix_length + (size_t)len + 1))
+        {
+            va_end(retry);
+            return false;
+        }
+        vsnprintf(strix_str(strix) + strix_length, (size_t)len + 1, format, retry);
+    }
+
+    va_end(retry);
+    strix_set_len(strix, strix_length + (size_t)len);
+    return true;
+}
+
+// appends format with the arguments in args; takes a pointer since a va_list parameter can't be passed on by address
+static bool strix_format(strix_t *strix, const char *format, va_list *args)
+{
+    // literal text, %s, %.*s (STRIX_FORMAT), %%, and %d, %i and %u with no modifier or l, ll or z are
+    // copied or converted here; the first other conversion hands the rest of the format to vsnprintf
+    const char *cursor = format;
+    while (*cursor)
+    {
+        const char *percent = strchr(cursor, '%');
+        size_t literal_len = percent ? (size_t)(percent - cursor) : strlen(cursor);
+        if (literal_len && !strix_append_bytes(strix, cursor, literal_len))
+        {
+            return false;
+        }
+        if (!percent)
+        {
+            break;
+        }
+
+        const char *spec = percent + 1;
+        bool appended = true;
+        if (spec[0] == '%')
+        {
+            appended = strix_append_bytes(strix, "%", 1);
+            cursor = spec + 1;
+        }
+        else if (spec[0] == 's')
+        {
+            const char *str = va_arg(*args, const char *);
+            appended = strix_append_bytes(strix, str, strlen(str));
+            cursor = spec + 1;
+        }
+        else if (spec[0] == '.' && spec[1] == '*' && spec[2] == 's')
+        {
+            int precision = va_arg(*args, int);
+            const char *str = va_arg(*args, const char *);
+            appended = strix_append_bytes(strix, str, precision < 0 ? strlen(str) : strnlen(str, (size_t)precision));
+            cursor = spec + 3;
+        }
+        else
+        {
+            const char *conversion = spec;
+            char modifier = 0;
+            if (conversion[0] == 'l' && conversion[1] == 'l')
+            {
+                modifier = 'L';
+                conversion += 2;
+            }
+            else if (conversion[0] == 'l' || conversion[0] == 'z')
+            {
+                modifier = *conversion++;
+            }
+
+            if (*conversion != 'd' && *conversion != 'i' && *conversion != 'u')
+            {
+                if (!strix_append_vsnprintf(strix, percent, *args))
+                {
+                    return false;
+                }
+                break;
+            }
+
+            bool negative = false;
+            uint64_t value = next_integer(args, modifier, *conversion != 'u', &negative);
+
+            char digits[24];
+            char *start = format_decimal(digits + sizeof(digits), value, negative);
+            appended = strix_append_bytes(strix, start, (size_t)(digits + sizeof(digits) - start));
+            cursor = conversion + 1;
+        }
+
+        if (!appended)
+        {
+            return false;
+        }
+    }
+
+    // the terminator lets the result go straight to C APIs; it is not part of len
+    if (!strix_grow(strix, strix_len(strix) + 1))
     {
-        strix_errno = STRIX_ERR_STRIX_STR_NULL;
         return false;
     }
+    strix_str(strix)[strix_len(strix)] = 0;
+    return true;
+}
 
-    if (strix->len <= pos)
+bool strix_vappendf(strix_t *strix, const char *format, va_list args)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_strix_null(strix) || is_str_null(format))
     {
-        strix_errno = STRIX_ERR_INVALID_POS;
         return false;
     }
 
-    char *new_str = (char *)allocate(sizeof(char) * (strlen(substr) + strix->len));
-    if (is_str_null(new_str))
+    va_list copy;
+    va_copy(copy, args);
+    bool result = strix_format(strix, format, &copy);
+    va_end(copy);
+    return result;
+}
+
+bool strix_appendf(strix_t *strix, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool result = strix_vappendf(strix, format, args);
+    va_end(args);
+    return result;
+}
+
+bool strix_insert_str(strix_t *strix, size_t pos, const char *substr)
+{
+    if (is_strix_null(strix) || is_str_null(substr))
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        strix_errno = STRIX_ERR_NULL_PTR;
         return false;
     }
 
-    if (!memcpy((void *)new_str, (void *)strix->str, pos))
+    if (is_strix_str_null(strix))
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
+        strix_errno = STRIX_ERR_STRIX_STR_NULL;
         return false;
     }
 
-    if (!memcpy(((void *)(uint8_t *)new_str + pos), (void *)substr, strlen(substr)))
+    if (strix_len(strix) <= pos)
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
+        strix_errno = STRIX_ERR_INVALID_POS;
         return false;
     }
 
-    if (!memcpy(((void *)(uint8_t *)new_str + pos + strlen(substr)), (void *)strix->str, strix->len - pos - 1))
+    size_t substr_len = strlen(substr);
+    if (!strix_open_gap(strix, pos, substr_len))
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
         return false;
     }
 
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len = strix->len + strlen(substr);
+    memcpy(strix_str(strix) + pos, substr, substr_len);
 
     strix_errno = STRIX_SUCCESS;
     return true;
@@ -362,44 +674,31 @@ bool strix_insert(strix_t *strix_dest, strix_t *strix_src, size_t pos)
         return false;
     }
 
-    if (strix_dest->len <= pos)
+    if (strix_len(strix_dest) <= pos)
     {
         strix_errno = STRIX_ERR_INVALID_POS;
         return false;
     }
 
-    char *substr = strix_src->str;
-    size_t len = strix_src->len;
-
-    char *new_str = (char *)allocate(sizeof(char) * (len + strix_dest->len));
-    if (is_str_null(new_str))
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
-    }
-
-    if (!memcpy((void *)new_str, (void *)strix_dest->str, pos))
+    // inserting a strix into itself copies the original halves around the gap
+    size_t len = strix_len(strix_src);
+    bool self = strix_src == strix_dest;
+    if (!strix_open_gap(strix_dest, pos, len))
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
         return false;
     }
 
-    if (!memcpy(((void *)(uint8_t *)new_str + pos), (void *)substr, len))
+    char *dest_str = strix_str(strix_dest);
+    if (self)
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
-        return false;
+        memcpy(dest_str + pos, dest_str, pos);
+        memcpy(dest_str + 2 * pos, dest_str + pos + len, len - pos);
     }
-
-    if (!memcpy(((void *)(uint8_t *)new_str + pos + len), (void *)strix_dest->str, strix_dest->len - pos - 1))
+    else
     {
-        strix_errno = STRIX_ERR_MEMMOVE_FAILED;
-        return false;
+        memcpy(dest_str + pos, strix_str(strix_src), len);
     }
 
-    deallocate(strix_dest->str);
-    strix_dest->str = new_str;
-    strix_dest->len = strix_dest->len + len;
-
     strix_errno = STRIX_SUCCESS;
     return true;
 }
@@ -418,39 +717,22 @@ bool strix_erase(strix_t *strix, size_t len, size_t pos)
         return false;
     }
 
-    if (pos >= strix->len)
+    size_t strix_length = strix_len(strix);
+    if (pos >= strix_length)
     {
         strix_errno = STRIX_ERR_INVALID_POS;
         return false;
     }
 
-    if (pos + len > strix->len)
-    {
-        len = strix->len - pos - 1;
-    }
-
-    char *new_str = (char *)allocate(sizeof(char) * (strix->len - len));
-    if (is_str_null(new_str))
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
-    }
-
-    if (!memcpy((void *)new_str, (void *)strix->str, pos + 1))
-    {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        return false;
-    }
-
-    if (!memcpy((void *)((uint8_t *)new_str + pos + 1), (void *)((uint8_t *)strix->str) + pos + len + 1, strix->len - pos - len - 1))
+    if (len > strix_length - pos)
     {
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        return false;
+        len = strix_length - pos;
     }
 
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len -= len;
+    // the buffer keeps its capacity; strix_shrink_to_fit gives it back
+    char *str = strix_str(strix);
+    memmove(str + pos, str + pos + len, strix_length - pos - len);
+    strix_set_len(strix, strix_length - len);
 
     strix_errno = STRIX_SUCCESS;
     return true;
@@ -464,14 +746,14 @@ char strix_at(const strix_t *strix, size_t index)
         return -1;
     }
 
-    if (index >= strix->len)
+    if (index >= strix_len(strix))
     {
         strix_errno = STRIX_ERR_OUT_OF_BOUNDS_ACCESS;
         return -1;
     }
 
     strix_errno = STRIX_SUCCESS;
-    return strix->str[index];
+    return strix_str(strix)[index];
 }
 
 int strix_equal(const strix_t *strix_one, const strix_t *strix_two)
@@ -488,15 +770,15 @@ int strix_equal(const strix_t *strix_one, const strix_t *strix_two)
         return -1;
     }
 
-    if (strix_one->len != strix_two->len)
+    if (strix_len(strix_one) != strix_len(strix_two))
     {
         return 1;
     }
 
     strix_errno = STRIX_SUCCESS;
 
-    size_t len = strix_one->len;
-    if (!strncmp(strix_one->str, strix_two->str, len))
+    size_t len = strix_len(strix_one);
+    if (!strncmp(strix_str(strix_one), strix_str(strix_two), len))
     {
         return 0;
     }
@@ -519,7 +801,7 @@ int64_t strix_find(const strix_t *strix, const char *substr)
     }
 
     strix_errno = STRIX_SUCCESS;
-    return kmp_search(substr, strix->str, strlen(substr), strix->len);
+    return string_search(substr, strix_str(strix), strlen(substr), strix_len(strix));
 }
 
 position_t *strix_find_all(const strix_t *strix, const char *substr)
@@ -536,44 +818,167 @@ position_t *strix_find_all(const strix_t *strix, const char *substr)
         return NULL;
     }
 
-    strix_errno = STRIX_SUCCESS;
-    return kmp_search_all(substr, strix->str, strlen(substr), strix->len);
+    strix_errno = STRIX_SUCCESS;
+    return string_search_all(substr, strix_str(strix), strlen(substr), strix_len(strix));
+}
+
+int64_t strix_find_subtrix(const strix_t *strix_one, const strix_t *strix_two)
+{
+    if (is_strix_null(strix_one) || is_strix_null(strix_two))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    if (is_strix_str_null(strix_one) || is_strix_str_null(strix_two))
+    {
+        strix_errno = STRIX_ERR_STRIX_STR_NULL;
+        return -1;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+    return string_search(strix_str(strix_two), strix_str(strix_one), strix_len(strix_two), strix_len(strix_one));
+}
+
+position_t *strix_find_subtrix_all(const strix_t *strix_one, const strix_t *strix_two)
+{
+    if (is_strix_null(strix_one) || is_strix_null(strix_two))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return NULL;
+    }
+
+    if (is_strix_str_null(strix_one) || is_strix_str_null(strix_two))
+    {
+        strix_errno = STRIX_ERR_STRIX_STR_NULL;
+        return NULL;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+    return string_search_all(strix_str(strix_two), strix_str(strix_one), strix_len(strix_two), strix_len(strix_one));
+}
+
+struct strix_pattern
+{
+    search_plan_t plan; // plan.pattern points at text
+    char text[];        // copy of the pattern, owned by the compiled pattern
+};
+
+static strix_pattern_t *pattern_compile(const char *str, size_t len)
+{
+    if (!len)
+    {
+        strix_errno = STRIX_ERR_EMPTY_STRING;
+        return NULL;
+    }
+
+    strix_pattern_t *pattern = (strix_pattern_t *)allocate(sizeof(strix_pattern_t) + len);
+    if (!pattern)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+
+    memcpy(pattern->text, str, len);
+    search_plan_init(&pattern->plan, pattern->text, len);
+
+    strix_errno = STRIX_SUCCESS;
+    return pattern;
+}
+
+strix_pattern_t *strix_pattern_compile(const char *substr)
+{
+    if (is_str_null(substr))
+    {
+        return NULL;
+    }
+
+    return pattern_compile(substr, strlen(substr));
+}
+
+strix_pattern_t *strix_pattern_compile_strix(const strix_t *substrix)
+{
+    if (is_strix_null(substrix))
+    {
+        return NULL;
+    }
+
+    if (strix_len(substrix) && is_strix_str_null(substrix))
+    {
+        strix_errno = STRIX_ERR_STRIX_STR_NULL;
+        return NULL;
+    }
+
+    return pattern_compile(strix_str(substrix), strix_len(substrix));
+}
+
+void strix_pattern_free(strix_pattern_t *pattern)
+{
+    if (!pattern)
+    {
+        return;
+    }
+
+    deallocate(pattern);
+}
+
+int64_t strix_pattern_find_view(const strix_pattern_t *pattern, strix_view_t view)
+{
+    if (!pattern || (!view.str && view.len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    strix_errno = STRIX_SUCCESS;
+    size_t found = search_plan_find(&pattern->plan, view.str, view.len, 0);
+    return found == SEARCH_NOT_FOUND ? -2 : (int64_t)found;
+}
+
+int64_t strix_pattern_find(const strix_pattern_t *pattern, const strix_t *strix)
+{
+    if (is_strix_null(strix))
+    {
+        return -1;
+    }
+
+    return strix_pattern_find_view(pattern, strix_view(strix));
 }
 
-int64_t strix_find_subtrix(const strix_t *strix_one, const strix_t *strix_two)
+position_t *strix_pattern_find_all(const strix_pattern_t *pattern, const strix_t *strix)
 {
-    if (is_strix_null(strix_one) || is_strix_null(strix_two))
+    if (!pattern || is_strix_null(strix))
     {
         strix_errno = STRIX_ERR_NULL_PTR;
-        return -1;
+        return NULL;
     }
 
-    if (is_strix_str_null(strix_one) || is_strix_str_null(strix_two))
+    if (strix_len(strix) && is_strix_str_null(strix))
     {
         strix_errno = STRIX_ERR_STRIX_STR_NULL;
-        return -1;
+        return NULL;
     }
 
     strix_errno = STRIX_SUCCESS;
-    return kmp_search(strix_two->str, strix_one->str, strix_two->len, strix_one->len);
+    return search_plan_find_all(&pattern->plan, strix_str(strix), strix_len(strix));
 }
 
-position_t *strix_find_subtrix_all(const strix_t *strix_one, const strix_t *strix_two)
+int64_t strix_pattern_count(const strix_pattern_t *pattern, const strix_t *strix)
 {
-    if (is_strix_null(strix_one) || is_strix_null(strix_two))
+    if (!pattern || is_strix_null(strix))
     {
         strix_errno = STRIX_ERR_NULL_PTR;
-        return NULL;
+        return -1;
     }
 
-    if (is_strix_str_null(strix_one) || is_strix_str_null(strix_two))
+    if (strix_len(strix) && is_strix_str_null(strix))
     {
         strix_errno = STRIX_ERR_STRIX_STR_NULL;
-        return NULL;
+        return -1;
     }
 
     strix_errno = STRIX_SUCCESS;
-    return kmp_search_all(strix_two->str, strix_one->str, strix_two->len, strix_one->len);
+    return search_plan_count(&pattern->plan, strix_str(strix), strix_len(strix));
 }
 
 void strix_position_free(position_t *position)
@@ -599,36 +1004,19 @@ void strix_free_strix_arr(strix_arr_t *strix_arr)
 
 strix_t *strix_slice(const strix_t *strix, size_t start, size_t end)
 {
-    if (start > end || end >= strix->len || is_strix_null(strix))
-    {
-        strix_errno = start > end || end >= strix->len ? STRIX_ERR_INVALID_BOUNDS : STRIX_ERR_NULL_PTR;
-        return NULL;
-    }
-
-    strix_t *slice = (strix_t *)allocate(sizeof(strix_t));
-    if (is_strix_null(slice))
+    if (start > end || end >= strix_len(strix) || is_strix_null(strix))
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        strix_errno = start > end || end >= strix_len(strix) ? STRIX_ERR_INVALID_BOUNDS : STRIX_ERR_NULL_PTR;
         return NULL;
     }
 
-    slice->len = end - start + 1;
-    slice->str = (char *)allocate(sizeof(char) * slice->len);
-    if (!slice->str)
+    strix_t *slice = strix_new(end - start + 1);
+    if (!slice)
     {
-        deallocate(slice);
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
 
-    void *result = memcpy(slice->str, strix->str + start, slice->len);
-    if (!result)
-    {
-        deallocate(slice->str);
-        deallocate(slice);
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        return NULL;
-    }
+    memcpy(strix_str(slice), strix_str(strix) + start, strix_len(slice));
 
     strix_errno = STRIX_SUCCESS;
     return slice;
@@ -642,6 +1030,15 @@ strix_arr_t *strix_split_by_delim(const strix_t *strix, const char delim)
         return NULL;
     }
 
+    // the pieces are counted first so that the array is allocated once, at its exact size
+    size_t piece_num = 0;
+    strix_view_t piece;
+    strix_split_iter_t iter = strix_split_iter(strix_view(strix), delim);
+    while (strix_split_next(&iter, &piece))
+    {
+        piece_num++;
+    }
+
     strix_arr_t *strix_arr_struct = (strix_arr_t *)allocate(sizeof(strix_arr_t));
     if (!strix_arr_struct)
     {
@@ -649,8 +1046,7 @@ strix_arr_t *strix_split_by_delim(const strix_t *strix, const char delim)
         return NULL;
     }
 
-    size_t current_max_size = MAX_SUBSTRIX_NUM;
-    strix_t **strix_arr = (strix_t **)allocate(sizeof(strix_t *) * current_max_size);
+    strix_t **strix_arr = (strix_t **)allocate(sizeof(strix_t *) * (piece_num ? piece_num : 1));
     if (!strix_arr)
     {
         deallocate(strix_arr_struct);
@@ -659,71 +1055,22 @@ strix_arr_t *strix_split_by_delim(const strix_t *strix, const char delim)
     }
 
     size_t len = 0;
-    size_t j = 0;
-
-    for (size_t i = 0; i <= strix->len; i++)
-    {
-        if (i == strix->len || strix->str[i] == delim)
-        {
-            if (i != j)
-            {
-                if (len >= current_max_size)
-                {
-                    size_t new_size = current_max_size * 2;
-                    strix_t **new_arr = (strix_t **)allocate(sizeof(strix_t *) * new_size);
-                    if (!new_arr)
-                    {
-                        for (size_t k = 0; k < len; k++)
-                        {
-                            deallocate(strix_arr[k]->str);
-                            deallocate(strix_arr[k]);
-                        }
-                        deallocate(strix_arr);
-                        deallocate(strix_arr_struct);
-                        strix_errno = STRIX_ERR_MALLOC_FAILED;
-                        return NULL;
-                    }
-
-                    for (size_t k = 0; k < len; k++)
-                    {
-                        new_arr[k] = strix_arr[k];
-                    }
-
-                    deallocate(strix_arr);
-                    strix_arr = new_arr;
-                    current_max_size = new_size;
-                }
-
-                strix_t *substrix = strix_slice(strix, j, i - 1);
-                if (is_strix_null(substrix))
-                {
-                    for (size_t k = 0; k < len; k++)
-                    {
-                        deallocate(strix_arr[k]->str);
-                        deallocate(strix_arr[k]);
-                    }
-                    deallocate(strix_arr);
-                    deallocate(strix_arr_struct);
-                    return NULL;
-                }
-                strix_arr[len++] = substrix;
-            }
-            j = i + 1;
-        }
-    }
-
-    if (len < current_max_size / 2)
+    iter = strix_split_iter(strix_view(strix), delim);
+    while (strix_split_next(&iter, &piece))
     {
-        strix_t **new_arr = (strix_t **)allocate(sizeof(strix_t *) * len);
-        if (new_arr)
+        strix_t *substrix = strix_from_view(piece);
+        if (is_strix_null(substrix))
         {
             for (size_t k = 0; k < len; k++)
             {
-                new_arr[k] = strix_arr[k];
+                strix_free(strix_arr[k]);
             }
             deallocate(strix_arr);
-            strix_arr = new_arr;
+            deallocate(strix_arr_struct);
+            strix_errno = STRIX_ERR_MALLOC_FAILED;
+            return NULL;
         }
+        strix_arr[len++] = substrix;
     }
 
     strix_arr_struct->len = len;
@@ -752,14 +1099,14 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr)
     }
     if (position->len == -1)
     {
-        deallocate(position);
+        strix_free_position(position);
         return NULL;
     }
 
     strix_arr_t *strix_arr_struct = (strix_arr_t *)allocate(sizeof(strix_arr_t));
     if (!strix_arr_struct)
     {
-        deallocate(position);
+        strix_free_position(position);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
@@ -769,7 +1116,7 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr)
         strix_t *copy = strix_duplicate(strix);
         if (!copy)
         {
-            deallocate(position);
+            strix_free_position(position);
             deallocate(strix_arr_struct);
             return NULL;
         }
@@ -777,21 +1124,22 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr)
         strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *));
         if (!strix_arr_struct->strix_arr)
         {
-            deallocate(position);
-            deallocate(copy);
+            strix_free_position(position);
+            strix_free(copy);
             deallocate(strix_arr_struct);
             strix_errno = STRIX_ERR_MALLOC_FAILED;
             return NULL;
         }
         strix_arr_struct->strix_arr[0] = copy;
-        deallocate(position);
+        strix_free_position(position);
         return strix_arr_struct;
     }
 
-    strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *) * MAX_SUBSTRIX_NUM);
+    // n matches leave at most n + 1 pieces
+    strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *) * ((size_t)position->len + 1));
     if (!strix_arr_struct->strix_arr)
     {
-        deallocate(position);
+        strix_free_position(position);
         deallocate(strix_arr_struct);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
@@ -816,9 +1164,9 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr)
 
         if (counter + 1 == position->len)
         {
-            if (start < strix->len)
+            if (start < strix_len(strix))
             {
-                substrix = strix_slice(strix, start, strix->len - 1);
+                substrix = strix_slice(strix, start, strix_len(strix) - 1);
             }
             else
             {
@@ -845,19 +1193,18 @@ strix_arr_t *strix_split_by_substr(const strix_t *strix, const char *substr)
         {
             for (size_t i = 0; i < len; i++)
             {
-                deallocate(strix_arr_struct->strix_arr[i]->str);
-                deallocate(strix_arr_struct->strix_arr[i]);
+                strix_free(strix_arr_struct->strix_arr[i]);
             }
             deallocate(strix_arr_struct->strix_arr);
             deallocate(strix_arr_struct);
-            deallocate(position);
+            strix_free_position(position);
             return NULL;
         }
         strix_arr_struct->strix_arr[len++] = substrix;
     }
 
     strix_arr_struct->len = len;
-    deallocate(position);
+    strix_free_position(position);
     strix_errno = STRIX_SUCCESS;
     return strix_arr_struct;
 }
@@ -882,14 +1229,14 @@ strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substr
     }
     if (position->len == -1)
     {
-        deallocate(position);
+        strix_free_position(position);
         return NULL;
     }
 
     strix_arr_t *strix_arr_struct = (strix_arr_t *)allocate(sizeof(strix_arr_t));
     if (!strix_arr_struct)
     {
-        deallocate(position);
+        strix_free_position(position);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
@@ -899,7 +1246,7 @@ strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substr
         strix_t *copy = strix_duplicate(strix);
         if (!copy)
         {
-            deallocate(position);
+            strix_free_position(position);
             deallocate(strix_arr_struct);
             return NULL;
         }
@@ -907,28 +1254,29 @@ strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substr
         strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *));
         if (!strix_arr_struct->strix_arr)
         {
-            deallocate(position);
-            deallocate(copy);
+            strix_free_position(position);
+            strix_free(copy);
             deallocate(strix_arr_struct);
             strix_errno = STRIX_ERR_MALLOC_FAILED;
             return NULL;
         }
         strix_arr_struct->strix_arr[0] = copy;
-        deallocate(position);
+        strix_free_position(position);
         return strix_arr_struct;
     }
 
-    strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *) * MAX_SUBSTRIX_NUM);
+    // n matches leave at most n + 1 pieces
+    strix_arr_struct->strix_arr = (strix_t **)allocate(sizeof(strix_t *) * ((size_t)position->len + 1));
     if (!strix_arr_struct->strix_arr)
     {
-        deallocate(position);
+        strix_free_position(position);
         deallocate(strix_arr_struct);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
 
     size_t len = 0;
-    size_t substr_len = substrix->len;
+    size_t substr_len = strix_len(substrix);
 
     if (position->pos[0] > 0)
     {
@@ -946,9 +1294,9 @@ strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substr
 
         if (counter + 1 == position->len)
         {
-            if (start < strix->len)
+            if (start < strix_len(strix))
             {
-                substrix = strix_slice(strix, start, strix->len - 1);
+                substrix = strix_slice(strix, start, strix_len(strix) - 1);
             }
             else
             {
@@ -975,25 +1323,22 @@ strix_arr_t *strix_split_by_substrix(const strix_t *strix, const strix_t *substr
         {
             for (size_t i = 0; i < len; i++)
             {
-                deallocate(strix_arr_struct->strix_arr[i]->str);
-                deallocate(strix_arr_struct->strix_arr[i]);
+                strix_free(strix_arr_struct->strix_arr[i]);
             }
             deallocate(strix_arr_struct->strix_arr);
             deallocate(strix_arr_struct);
-            deallocate(position);
+            strix_free_position(position);
             return NULL;
         }
         strix_arr_struct->strix_arr[len++] = substrix;
     }
 
     strix_arr_struct->len = len;
-    deallocate(position);
+    strix_free_position(position);
     strix_errno = STRIX_SUCCESS;
     return strix_arr_struct;
 }
 
-#undef MAX_SUBSTRIX_NUM
-#undef MAX_POSITIONS
 
 strix_t *strix_join_via_delim(const strix_t **strix_arr, size_t len, const char delim)
 {
@@ -1011,35 +1356,25 @@ strix_t *strix_join_via_delim(const strix_t **strix_arr, size_t len, const char
             strix_errno = STRIX_ERR_NULL_PTR;
             return NULL;
         }
-        total_len += strix_arr[i]->len;
+        total_len += strix_len(strix_arr[i]);
     }
     total_len += len - 1; // add space for delimiters
 
-    strix_t *result = (strix_t *)allocate(sizeof(strix_t));
+    strix_t *result = strix_new(total_len);
     if (!result)
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    result->str = (char *)allocate(sizeof(char) * total_len);
-    if (!result->str)
-    {
-        deallocate(result);
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
-    result->len = total_len;
 
-    char *ptr = result->str;
+    char *ptr = strix_str(result);
     for (size_t i = 0; i < len; i++)
     {
-        if (!memcpy(ptr, strix_arr[i]->str, strix_arr[i]->len))
+        if (!memcpy(ptr, strix_str(strix_arr[i]), strix_len(strix_arr[i])))
         {
             strix_errno = STRIX_ERR_MEMCPY_FAILED;
             return NULL;
         }
-        ptr += strix_arr[i]->len;
+        ptr += strix_len(strix_arr[i]);
         if (i < len - 1)
         {
             *ptr = delim;
@@ -1069,35 +1404,25 @@ strix_t *strix_join_via_substr(const strix_t **strix_arr, size_t len, const char
             strix_errno = STRIX_ERR_NULL_PTR;
             return NULL;
         }
-        total_len += strix_arr[i]->len;
+        total_len += strix_len(strix_arr[i]);
     }
     total_len += (len - 1) * substr_len;
 
-    strix_t *result = (strix_t *)allocate(sizeof(strix_t));
+    strix_t *result = strix_new(total_len);
     if (!result)
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    result->str = (char *)allocate(sizeof(char) * total_len);
-    if (!result->str)
-    {
-        deallocate(result);
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
-    result->len = total_len;
 
-    char *ptr = result->str;
+    char *ptr = strix_str(result);
     for (size_t i = 0; i < len; i++)
     {
-        if (!memcpy(ptr, strix_arr[i]->str, strix_arr[i]->len))
+        if (!memcpy(ptr, strix_str(strix_arr[i]), strix_len(strix_arr[i])))
         {
             strix_errno = STRIX_ERR_MEMCPY_FAILED;
             return NULL;
         }
-        ptr += strix_arr[i]->len;
+        ptr += strix_len(strix_arr[i]);
         if (i < len - 1)
         {
             if (!memcpy(ptr, substr, substr_len))
@@ -1129,43 +1454,33 @@ strix_t *strix_join_via_substrix(const strix_t **strix_arr, size_t len, const st
             strix_errno = STRIX_ERR_NULL_PTR;
             return NULL;
         }
-        total_len += strix_arr[i]->len;
+        total_len += strix_len(strix_arr[i]);
     }
-    total_len += (len - 1) * substrix->len;
+    total_len += (len - 1) * strix_len(substrix);
 
-    strix_t *result = (strix_t *)allocate(sizeof(strix_t));
+    strix_t *result = strix_new(total_len);
     if (!result)
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    result->str = (char *)allocate(sizeof(char) * total_len);
-    if (!result->str)
-    {
-        deallocate(result);
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
-    result->len = total_len;
 
-    char *ptr = result->str;
+    char *ptr = strix_str(result);
     for (size_t i = 0; i < len; i++)
     {
-        if (!memcpy(ptr, strix_arr[i]->str, strix_arr[i]->len))
+        if (!memcpy(ptr, strix_str(strix_arr[i]), strix_len(strix_arr[i])))
         {
             strix_errno = STRIX_ERR_MEMCPY_FAILED;
             return NULL;
         }
-        ptr += strix_arr[i]->len;
+        ptr += strix_len(strix_arr[i]);
         if (i < len - 1)
         {
-            if (!memcpy(ptr, substrix->str, substrix->len))
+            if (!memcpy(ptr, strix_str(substrix), strix_len(substrix)))
             {
                 strix_errno = STRIX_ERR_MEMCPY_FAILED;
                 return NULL;
             }
-            ptr += substrix->len;
+            ptr += strix_len(substrix);
         }
     }
 
@@ -1185,49 +1500,35 @@ bool strix_trim_whitespace(strix_t *strix)
         strix_errno = STRIX_ERR_STRIX_STR_NULL;
         return false;
     }
-    if (strix->len == 0)
+    char *str = strix_str(strix);
+    size_t len = strix_len(strix);
+    if (len == 0)
     {
         return true;
     }
 
     size_t start = 0;
-    while (start < strix->len && isspace((unsigned char)strix->str[start]))
+    while (start < len && char_is_space[(unsigned char)str[start]])
     {
         start++;
     }
 
-    if (start == strix->len)
+    if (start == len)
     {
-        deallocate(strix->str);
-        strix->str = NULL;
-        strix->len = 0;
+        strix_release(strix);
+        strix_set_heap(strix, NULL, 0, 0);
         return true;
     }
 
-    size_t end = strix->len - 1;
-    while (end > start && isspace((unsigned char)strix->str[end]))
+    size_t end = len - 1;
+    while (end > start && char_is_space[(unsigned char)str[end]])
     {
         end--;
     }
 
-    size_t new_len = end - start + 1;
-    char *new_str = allocate(new_len);
-    if (!new_str)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
-    }
-
-    if (memcpy(new_str, strix->str + start, new_len) == NULL)
-    {
-        deallocate(new_str);
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        return false;
-    }
-
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len = new_len;
+    // trimmed in place; the capacity is kept
+    memmove(str, str + start, end - start + 1);
+    strix_set_len(strix, end - start + 1);
     return true;
 }
 
@@ -1243,205 +1544,99 @@ bool strix_trim_char(strix_t *strix, const char trim)
         strix_errno = STRIX_ERR_STRIX_STR_NULL;
         return false;
     }
-    if (strix->len == 0)
+    char *str = strix_str(strix);
+    size_t len = strix_len(strix);
+    if (len == 0)
     {
         return true;
     }
 
     size_t start = 0;
-    while (start < strix->len && strix->str[start] == trim)
+    while (start < len && str[start] == trim)
     {
         start++;
     }
 
-    if (start == strix->len)
+    if (start == len)
     {
-        deallocate(strix->str);
-        strix->str = NULL;
-        strix->len = 0;
+        strix_release(strix);
+        strix_set_heap(strix, NULL, 0, 0);
         return true;
     }
 
-    size_t end = strix->len - 1;
-    while (end > start && strix->str[end] == trim)
+    size_t end = len - 1;
+    while (end > start && str[end] == trim)
     {
         end--;
     }
 
-    size_t new_len = end - start + 1;
-    char *new_str = allocate(new_len);
-    if (!new_str)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
-    }
-
-    if (memcpy(new_str, strix->str + start, new_len) == NULL)
-    {
-        deallocate(new_str);
-        strix_errno = STRIX_ERR_MEMCPY_FAILED;
-        return false;
-    }
-
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len = new_len;
+    // trimmed in place; the capacity is kept
+    memmove(str, str + start, end - start + 1);
+    strix_set_len(strix, end - start + 1);
     return true;
 }
 
 double strix_to_double(strix_t *strix)
 {
-    double num = 0;
-    double fraction_part = 0;
-    bool is_neg = false;
-    bool in_fraction = false;
-    double divisor = 1;
-    strix_errno = STRIX_SUCCESS;
-
-    for (size_t i = 0; i < strix->len; i++)
+    if (is_strix_null(strix))
     {
-        char ch = strix->str[i];
-
-        if (ch == '-')
-        {
-            if (i > 0)
-            {
-                strix_errno = STRIX_ERR_INVALID_DOUBLE;
-                return -1;
-            }
-            is_neg = true;
-            continue;
-        }
-
-        if (ch == '+')
-        {
-            if (i > 0)
-            {
-                strix_errno = STRIX_ERR_INVALID_DOUBLE;
-                return -1;
-            }
-            continue;
-        }
-
-        if (ch == '.')
-        {
-            if (in_fraction)
-            {
-                strix_errno = STRIX_ERR_INVALID_DOUBLE;
-                return -1;
-            }
-            in_fraction = true;
-            continue;
-        }
+        return -1;
+    }
 
-        int dig = ch - '0';
-        if (dig < 0 || dig > 9)
+    double value;
+    size_t consumed = strix_view_to_double(strix_view(strix), &value);
+    if (!consumed || consumed != strix_len(strix))
+    {
+        if (consumed) // trailing characters
         {
             strix_errno = STRIX_ERR_INVALID_DOUBLE;
-            return -1;
-        }
-
-        if (in_fraction)
-        {
-            divisor *= 10;
-            fraction_part += dig / divisor;
-        }
-        else
-        {
-            num = num * 10 + dig;
         }
+        return -1;
     }
 
-    double result = num + fraction_part;
-    return is_neg ? -result : result;
+    return value;
 }
 
 uint64_t strix_to_unsigned_int(strix_t *strix)
 {
-    strix_errno = STRIX_SUCCESS;
-    uint64_t num = 0;
-
-    for (size_t i = 0; i < strix->len; i++)
+    if (is_strix_null(strix))
     {
-        char ch = strix->str[i];
-
-        if (ch == '+')
-        {
-            if (i > 0)
-            {
-                strix_errno = STRIX_ERR_INVALID_INT;
-                return 0;
-            }
-            continue;
-        }
+        return 0;
+    }
 
-        int dig = ch - '0';
-        if (dig < 0 || dig > 9)
+    uint64_t value;
+    size_t consumed = strix_view_to_unsigned_int(strix_view(strix), &value);
+    if (!consumed || consumed != strix_len(strix))
+    {
+        if (consumed) // trailing characters
         {
             strix_errno = STRIX_ERR_INVALID_INT;
-            return 0;
         }
-
-        if (num > (UINT64_MAX - dig) / 10)
-        {
-            strix_errno = STRIX_ERR_INT_OVERFLOW;
-            return 0;
-        }
-
-        num = num * 10 + dig;
+        return 0;
     }
 
-    return num;
+    return value;
 }
 
 int64_t strix_to_signed_int(strix_t *strix)
 {
-    strix_errno = STRIX_SUCCESS;
-    bool is_neg = false;
-    int64_t num = 0;
-
-    for (size_t i = 0; i < strix->len; i++)
+    if (is_strix_null(strix))
     {
-        char ch = strix->str[i];
-
-        if (ch == '+')
-        {
-            if (i > 0)
-            {
-                strix_errno = STRIX_ERR_INVALID_INT;
-                return 0;
-            }
-            continue;
-        }
-
-        if (ch == '-')
-        {
-            if (i > 0)
-            {
-                strix_errno = STRIX_ERR_INVALID_INT;
-                return 0;
-            }
-            is_neg = true;
-            continue;
-        }
+        return 0;
+    }
 
-        int dig = ch - '0';
-        if (dig < 0 || dig > 9)
+    int64_t value;
+    size_t consumed = strix_view_to_signed_int(strix_view(strix), &value);
+    if (!consumed || consumed != strix_len(strix))
+    {
+        if (consumed) // trailing characters
         {
             strix_errno = STRIX_ERR_INVALID_INT;
-            return 0;
-        }
-
-        if (num > (INT64_MAX - dig) / 10)
-        {
-            strix_errno = STRIX_ERR_INT_OVERFLOW;
-            return 0;
         }
-
-        num = num * 10 + dig;
+        return 0;
     }
 
-    return is_neg ? -num : num;
+    return value;
 }
 
 int64_t strix_count_char(const strix_t *strix, const char chr)
@@ -1458,16 +1653,7 @@ int64_t strix_count_char(const strix_t *strix, const char chr)
         return -1;
     }
 
-    int64_t count = 0;
-    for (size_t counter = 0; counter < strix->len; counter++)
-    {
-        if (strix->str[counter] == chr)
-        {
-            count++;
-        }
-    }
-
-    return count;
+    return (int64_t)char_kernels()->count(strix_str(strix), strix_len(strix), chr);
 }
 
 int64_t strix_count_substr(const strix_t *strix, const char *substr)
@@ -1483,7 +1669,7 @@ int64_t strix_count_substr(const strix_t *strix, const char *substr)
         return -1;
     }
 
-    return kmp_search_all_len(substr, strix->str, strlen(substr), strix->len);
+    return string_search_all_len(substr, strix_str(strix), strlen(substr), strix_len(strix));
 }
 
 int64_t strix_count_substrix(const strix_t *strix, const strix_t *substrix)
@@ -1499,14 +1685,14 @@ int64_t strix_count_substrix(const strix_t *strix, const strix_t *substrix)
         return -1;
     }
 
-    return kmp_search_all_len(substrix->str, strix->str, substrix->len, strix->len);
+    return string_search_all_len(strix_str(substrix), strix_str(strix), strix_len(substrix), strix_len(strix));
 }
 
 strix_t *strix_slice_by_stride(const strix_t *strix, size_t start, size_t end, size_t stride)
 {
-    if (start > end || end >= strix->len || is_strix_null(strix))
+    if (start > end || end >= strix_len(strix) || is_strix_null(strix))
     {
-        strix_errno = start > end || end >= strix->len ? STRIX_ERR_INVALID_BOUNDS : STRIX_ERR_NULL_PTR;
+        strix_errno = start > end || end >= strix_len(strix) ? STRIX_ERR_INVALID_BOUNDS : STRIX_ERR_NULL_PTR;
         return NULL;
     }
 
@@ -1519,25 +1705,15 @@ strix_t *strix_slice_by_stride(const strix_t *strix, size_t start, size_t end, s
     size_t range = end - start + 1;
     size_t slice_len = (range + stride - 1) / stride; // Ceiling division
 
-    strix_t *slice = (strix_t *)allocate(sizeof(strix_t));
-    if (is_strix_null(slice))
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return NULL;
-    }
-
-    slice->len = slice_len;
-    slice->str = (char *)allocate(sizeof(char) * slice_len);
-    if (!slice->str)
+    strix_t *slice = strix_new(slice_len);
+    if (!slice)
     {
-        deallocate(slice);
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
 
     for (size_t i = 0, src_idx = start; i < slice_len; i++, src_idx += stride)
     {
-        slice->str[i] = strix->str[src_idx];
+        strix_str(slice)[i] = strix_str(strix)[src_idx];
     }
 
     strix_errno = STRIX_SUCCESS;
@@ -1558,9 +1734,8 @@ char_arr_t *strix_find_unique_char(strix_t *strix)
         return NULL;
     }
 
-#define MAX_UNIQUE 128
-
-    char *unique_char_arr = (char *)allocate(MAX_UNIQUE * sizeof(char));
+    // a string holds at most 256 distinct bytes, whatever its length
+    char *unique_char_arr = (char *)allocate(256 * sizeof(char));
     if (!unique_char_arr)
     {
         strix_errno = STRIX_ERR_MALLOC_FAILED;
@@ -1570,6 +1745,7 @@ char_arr_t *strix_find_unique_char(strix_t *strix)
     char_arr_t *char_arr = (char_arr_t *)allocate(sizeof(char_arr_t));
     if (!char_arr)
     {
+        deallocate(unique_char_arr);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
@@ -1577,22 +1753,22 @@ char_arr_t *strix_find_unique_char(strix_t *strix)
     char_arr->len = 0;
     char_arr->unique_char_arr = unique_char_arr;
 
-    bool found[MAX_UNIQUE] = {false};
-
-    for (size_t counter = 0; counter < strix->len; counter++)
+    // one bit per byte value; bytes above 127 index it like any other
+    uint64_t seen[4] = {0};
+    for (size_t counter = 0; counter < strix_len(strix) && char_arr->len < 256; counter++)
     {
-        if (!found[strix->str[counter]])
+        unsigned char chr = (unsigned char)strix_str(strix)[counter];
+        uint64_t bit = (uint64_t)1 << (chr & 63);
+        if (!(seen[chr >> 6] & bit))
         {
-            found[strix->str[counter]] = true;
-            char_arr->unique_char_arr[char_arr->len++] = strix->str[counter];
+            seen[chr >> 6] |= bit;
+            char_arr->unique_char_arr[char_arr->len++] = (char)chr;
         }
     }
 
     return char_arr;
 }
 
-#undef MAX_UNIQUE
-
 bool strix_delete_occurence(strix_t *strix, const char *substr)
 {
     if (is_strix_null(strix) || is_str_null(substr))
@@ -1607,55 +1783,31 @@ bool strix_delete_occurence(strix_t *strix, const char *substr)
         return false;
     }
 
-    position_t *positions = strix_find_all(strix, substr);
-    if (positions == NULL)
+    size_t substr_len = strlen(substr);
+    if (!substr_len)
     {
         strix_errno = STRIX_SUCCESS;
         return true;
     }
 
-    size_t substr_len = strlen(substr);
-    size_t new_len = strix->len - (substr_len * positions->len);
-
-    char *new_str = (char *)allocate((new_len) * sizeof(char));
-    if (new_str == NULL)
-    {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
-    }
-
-    size_t current_pos = 0;
-    size_t copy_pos = 0;
-
-    for (int64_t i = 0; i < positions->len; i++)
-    {
-        size_t substr_pos = positions->pos[i];
-        size_t copy_len = substr_pos - current_pos;
-
-        if (memcpy(new_str + copy_pos, strix->str + current_pos, copy_len) == NULL)
-        {
-            deallocate(new_str);
-            strix_errno = STRIX_ERR_MEMCPY_FAILED;
-            return false;
-        }
-
-        copy_pos += copy_len;
-        current_pos = substr_pos + substr_len;
-    }
+    search_plan_t plan;
+    search_plan_init(&plan, substr, substr_len);
 
-    if (current_pos < strix->len)
+    // matches are removed left to right without overlapping, compacting the string in place;
+    // the search only reads from read onwards, and the compaction only writes before it
+    char *str = strix_str(strix);
+    size_t len = strix_len(strix);
+    size_t read = 0;
+    size_t write = 0;
+    for (size_t found = search_plan_find(&plan, str, len, 0); found != SEARCH_NOT_FOUND; found = search_plan_find(&plan, str, len, read))
     {
-        if (memcpy(new_str + copy_pos, strix->str + current_pos, strix->len - current_pos) == NULL)
-        {
-            deallocate(new_str);
-            strix_errno = STRIX_ERR_MEMCPY_FAILED;
-            return false;
-        }
+        memmove(str + write, str + read, found - read);
+        write += found - read;
+        read = found + substr_len;
     }
 
-    deallocate(strix->str);
-    strix->str = new_str;
-    strix->len = new_len;
+    memmove(str + write, str + read, len - read);
+    strix_set_len(strix, write + (len - read));
 
     strix_errno = STRIX_SUCCESS;
     return true;
@@ -1686,100 +1838,199 @@ position_t *strix_find_all_char(const strix_t *strix, const char chr)
         return NULL;
     }
 
+    // the matches are counted first so that the positions fit exactly, however many there are
+    int64_t count = strix_count_char(strix, chr);
+    if (count < 0)
+    {
+        return NULL;
+    }
+
     position_t *posn = (position_t *)malloc(sizeof(position_t));
     if (!posn)
     {
         strix_errno = STRIX_ERR_MALLOC_FAILED;
-        return false;
+        return NULL;
     }
 
-#define MAX_POSITIONS 1024
-    size_t *pos_arr = (size_t *)malloc(sizeof(size_t) * MAX_POSITIONS);
+    size_t *pos_arr = (size_t *)malloc(sizeof(size_t) * (count ? (size_t)count : 1));
     if (!pos_arr)
     {
+        free(posn);
         strix_errno = STRIX_ERR_MALLOC_FAILED;
         return NULL;
     }
-#undef MAX_POSITIONS
 
-    size_t len = 0;
+    posn->pos = pos_arr;
+    posn->len = (int64_t)char_kernels()->find_all(strix_str(strix), 0, strix_len(strix), chr, pos_arr);
+
+    return posn;
+}
+
+// files smaller than this are read rather than mapped; setting up and tearing down a mapping costs more than copying them
+#define STRIX_MAP_MIN_LEN (16 * 1024)
+
+typedef struct
+{
+    strix_t strix; // kept first so that strix_unmap_file can get from the strix back to the mapping
+    bool mapped;   // whether strix.heap.str is an mmap region rather than an allocated buffer
+} strix_mapping_t;
+
+// reads fd to its end into an allocated buffer; size_hint is the expected length (0 if unknown)
+static bool read_whole_fd(int fd, size_t size_hint, char **data, size_t *len)
+{
+    // one byte more than the expected length lets the read reaching the end of file share the buffer
+    size_t capacity = size_hint ? size_hint + 1 : 4096;
+    char *buffer = (char *)allocate(capacity);
+    if (!buffer)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return false;
+    }
 
-    for (size_t counter = 0; counter < strix->len; counter++)
+    size_t filled = 0;
+    while (true)
     {
-        if (strix->str[counter] == chr)
+        if (filled == capacity)
         {
-            pos_arr[len++] = counter;
+            // pipes and files that grew since fstat; the allocator has no realloc
+            char *grown = (char *)allocate(capacity * 2);
+            if (!grown)
+            {
+                strix_errno = STRIX_ERR_MALLOC_FAILED;
+                deallocate(buffer);
+                return false;
+            }
+            memcpy(grown, buffer, filled);
+            deallocate(buffer);
+            buffer = grown;
+            capacity *= 2;
         }
-    }
 
-    posn->pos = pos_arr;
-    posn->len = len;
+        ssize_t bytes_read = read(fd, buffer + filled, capacity - filled);
+        if (bytes_read == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            strix_errno = STRIX_ERR_STDIO;
+            deallocate(buffer);
+            return false;
+        }
 
-    return posn;
+        if (!bytes_read)
+        {
+            break;
+        }
+        filled += (size_t)bytes_read;
+    }
+
+    *data = buffer;
+    *len = filled;
+    return true;
 }
 
-strix_t *conv_file_to_strix(const char *file_path)
+const strix_t *strix_map_file(const char *file_path)
 {
-    if (!file_path)
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_str_null(file_path))
     {
-        strix_errno = STRIX_ERR_NULL_PTR;
         return NULL;
     }
 
-    FILE *input_file = fopen(file_path, "r");
-    if (!input_file)
+    int fd = open(file_path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1)
     {
         strix_errno = STRIX_ERR_STDIO;
         return NULL;
     }
 
-    if (fseek(input_file, 0, SEEK_END) != 0)
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1)
     {
         strix_errno = STRIX_ERR_STDIO;
+        close(fd);
         return NULL;
     }
 
-    long input_file_len = ftell(input_file);
-    if (input_file_len < 0)
+    strix_mapping_t *mapping = (strix_mapping_t *)allocate(sizeof(strix_mapping_t));
+    if (!mapping)
     {
-        strix_errno = STRIX_ERR_STDIO;
-        fclose(input_file);
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        close(fd);
         return NULL;
     }
+    mapping->mapped = false;
 
-    if (fseek(input_file, 0, SEEK_SET) != 0)
+    char *data = NULL;
+    size_t len = 0;
+    size_t file_len = S_ISREG(file_stat.st_mode) ? (size_t)file_stat.st_size : 0;
+    if (file_len >= STRIX_MAP_MIN_LEN && file_len <= STRIX_CAPACITY_MAX)
     {
-        strix_errno = STRIX_ERR_STDIO;
-        fclose(input_file);
-        return NULL;
+        void *region = mmap(NULL, file_len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (region != MAP_FAILED)
+        {
+            madvise(region, file_len, MADV_SEQUENTIAL);
+            data = (char *)region;
+            len = file_len;
+            mapping->mapped = true;
+        }
     }
 
-    uint8_t *input_file_array = (uint8_t *)allocate((input_file_len + 1) * sizeof(uint8_t));
-    if (!input_file_array)
+    if (!mapping->mapped && !read_whole_fd(fd, file_len, &data, &len))
     {
-        strix_errno = STRIX_ERR_MALLOC_FAILED;
-        fclose(input_file);
+        deallocate(mapping);
+        close(fd);
         return NULL;
     }
-    input_file_array[input_file_len] = '\0';
+    close(fd);
 
-    size_t bytes_read = fread(input_file_array, 1, input_file_len, input_file);
-    if (bytes_read != (size_t)input_file_len)
+    if (len > STRIX_CAPACITY_MAX)
     {
-        strix_errno = STRIX_ERR_STDIO;
-        deallocate(input_file_array);
-        fclose(input_file);
+        strix_errno = STRIX_ERR_INVALID_LENGTH;
+        deallocate(data);
+        deallocate(mapping);
         return NULL;
     }
-    fclose(input_file);
 
-    strix_t *input_strix = strix_create((const char *)input_file_array);
-    deallocate(input_file_array);
-    if (!input_strix)
+    // always a heap strix, even when short, so that strix_unmap_file finds the buffer;
+    // the strix is handed out read-only, so it never grows
+    strix_set_heap(&mapping->strix, data, len, len);
+    return &mapping->strix;
+}
+
+void strix_unmap_file(const strix_t *file)
+{
+    if (!file)
+    {
+        return;
+    }
+
+    strix_mapping_t *mapping = (strix_mapping_t *)file;
+    if (mapping->mapped)
+    {
+        munmap(mapping->strix.heap.str, mapping->strix.heap.len);
+    }
+    else
+    {
+        deallocate(mapping->strix.heap.str);
+    }
+    deallocate(mapping);
+}
+
+#undef STRIX_MAP_MIN_LEN
+
+strix_t *conv_file_to_strix(const char *file_path)
+{
+    const strix_t *file = strix_map_file(file_path);
+    if (!file)
     {
         return NULL;
     }
 
+    strix_t *input_strix = strix_duplicate(file);
+    strix_unmap_file(file);
     return input_strix;
 }
 
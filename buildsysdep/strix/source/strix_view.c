@@ -0,0 +1,279 @@
+#include "../header/strix.h"
+#include "../allocator/allocator.h"
+
+static const strix_view_t null_view = {NULL, 0};
+
+strix_view_t strix_view(const strix_t *strix)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_strix_null(strix))
+    {
+        return null_view;
+    }
+
+    strix_view_t view = {strix_str(strix), strix_len(strix)};
+    return view;
+}
+
+strix_view_t strix_view_from_cstr(const char *str)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (is_str_null(str))
+    {
+        return null_view;
+    }
+
+    strix_view_t view = {str, strlen(str)};
+    return view;
+}
+
+strix_t *strix_from_view(strix_view_t view)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (!view.len)
+    {
+        return strix_create_empty();
+    }
+
+    if (is_str_null(view.str))
+    {
+        return NULL;
+    }
+
+    strix_t *strix = strix_new(view.len);
+    if (!strix)
+    {
+        return NULL;
+    }
+
+    memcpy(strix_str(strix), view.str, view.len);
+    return strix;
+}
+
+strix_view_t strix_view_slice(strix_view_t view, size_t start, size_t end)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (start > end || end > view.len)
+    {
+        strix_errno = STRIX_ERR_INVALID_BOUNDS;
+        return null_view;
+    }
+
+    strix_view_t slice = {view.str + start, end - start};
+    return slice;
+}
+
+strix_view_t strix_view_trim_whitespace(strix_view_t view)
+{
+    while (view.len && char_is_space[(unsigned char)view.str[0]])
+    {
+        view.str++;
+        view.len--;
+    }
+
+    while (view.len && char_is_space[(unsigned char)view.str[view.len - 1]])
+    {
+        view.len--;
+    }
+
+    return view;
+}
+
+strix_view_t strix_view_trim_char(strix_view_t view, const char trim)
+{
+    while (view.len && view.str[0] == trim)
+    {
+        view.str++;
+        view.len--;
+    }
+
+    while (view.len && view.str[view.len - 1] == trim)
+    {
+        view.len--;
+    }
+
+    return view;
+}
+
+bool strix_view_equal(strix_view_t view_one, strix_view_t view_two)
+{
+    return view_one.len == view_two.len && (!view_one.len || !memcmp(view_one.str, view_two.str, view_one.len));
+}
+
+int64_t strix_view_find_char(strix_view_t view, const char chr)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (!view.len)
+    {
+        return -2;
+    }
+
+    const char *found = (const char *)memchr(view.str, chr, view.len);
+    return found ? (int64_t)(found - view.str) : -2;
+}
+
+int64_t strix_view_find(strix_view_t view, strix_view_t needle)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if ((!view.str && view.len) || (!needle.str && needle.len))
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return -1;
+    }
+
+    return string_search(needle.str, view.str, needle.len, view.len);
+}
+
+bool strix_view_cut(strix_view_t view, const char delim, strix_view_t *before, strix_view_t *after)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (!before || !after)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    int64_t index = strix_view_find_char(view, delim);
+    if (index < 0)
+    {
+        *before = view;
+        after->str = view.str + view.len;
+        after->len = 0;
+        return false;
+    }
+
+    before->str = view.str;
+    before->len = (size_t)index;
+    after->str = view.str + index + 1;
+    after->len = view.len - (size_t)index - 1;
+    return true;
+}
+
+strix_split_iter_t strix_split_iter(strix_view_t view, const char delim)
+{
+    strix_split_iter_t iter = {view, {NULL, 0}, delim};
+    return iter;
+}
+
+strix_split_iter_t strix_split_iter_substr(strix_view_t view, strix_view_t separator)
+{
+    strix_split_iter_t iter = {view, separator, 0};
+    return iter;
+}
+
+bool strix_split_next(strix_split_iter_t *iter, strix_view_t *token)
+{
+    if (!iter || !token)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    size_t separator_len = iter->separator.len ? iter->separator.len : 1;
+    while (iter->rest.len)
+    {
+        int64_t index = iter->separator.len ? strix_view_find(iter->rest, iter->separator) : strix_view_find_char(iter->rest, iter->delim);
+        size_t end = index >= 0 ? (size_t)index : iter->rest.len;
+
+        token->str = iter->rest.str;
+        token->len = end;
+
+        size_t consumed = index >= 0 ? end + separator_len : end;
+        iter->rest.str += consumed;
+        iter->rest.len -= consumed;
+
+        if (token->len) // empty pieces between adjacent separators are skipped
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+strix_find_iter_t strix_find_iter(strix_view_t view, strix_view_t needle)
+{
+    strix_find_iter_t iter = {view, needle, 0};
+    return iter;
+}
+
+bool strix_find_next(strix_find_iter_t *iter, size_t *pos)
+{
+    if (!iter || !pos)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return false;
+    }
+
+    if (!iter->needle.len || iter->offset >= iter->view.len)
+    {
+        return false;
+    }
+
+    strix_view_t rest = {iter->view.str + iter->offset, iter->view.len - iter->offset};
+    int64_t index = strix_view_find(rest, iter->needle);
+    if (index < 0)
+    {
+        iter->offset = iter->view.len;
+        return false;
+    }
+
+    // like strix_find_all, matches may overlap, so the next search starts one past this match
+    *pos = iter->offset + (size_t)index;
+    iter->offset = *pos + 1;
+    return true;
+}
+
+strix_view_arr_t *strix_view_split_by_delim(strix_view_t view, const char delim)
+{
+    strix_errno = STRIX_SUCCESS;
+
+    if (!view.str && view.len)
+    {
+        strix_errno = STRIX_ERR_NULL_PTR;
+        return NULL;
+    }
+
+    // the pieces are counted first so that the array and its views take a single allocation
+    size_t piece_num = 0;
+    strix_view_t piece;
+    strix_split_iter_t iter = strix_split_iter(view, delim);
+    while (strix_split_next(&iter, &piece))
+    {
+        piece_num++;
+    }
+
+    strix_view_arr_t *view_arr = (strix_view_arr_t *)allocate(sizeof(strix_view_arr_t) + piece_num * sizeof(strix_view_t));
+    if (!view_arr)
+    {
+        strix_errno = STRIX_ERR_MALLOC_FAILED;
+        return NULL;
+    }
+
+    view_arr->view_arr = (strix_view_t *)(view_arr + 1);
+    view_arr->len = 0;
+    iter = strix_split_iter(view, delim);
+    while (strix_split_next(&iter, &piece))
+    {
+        view_arr->view_arr[view_arr->len++] = piece;
+    }
+
+    return view_arr;
+}
+
+void strix_free_view_arr(strix_view_arr_t *view_arr)
+{
+    if (!view_arr)
+    {
+        return;
+    }
+
+    deallocate(view_arr); // the views share the allocation of the array
+}